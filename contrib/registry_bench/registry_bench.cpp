@@ -0,0 +1,185 @@
+/*
+ * Lookup benchmark for the global guid registry (HashMapHolder in src/game/ObjectAccessor.h).
+ *
+ * Compares the old single reader/writer lock with the sharded one: N reader threads do
+ * guid lookups like the map threads do while one writer thread keeps inserting and removing
+ * objects like grid loading and respawns do. Plain pthreads so it builds without ACE,
+ * ACE_RW_Thread_Mutex is a pthread_rwlock_t on linux anyway.
+ *
+ *   g++ -O2 -pthread -o registry_bench registry_bench.cpp
+ *   ./registry_bench [threads] [seconds] [objects]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <tr1/unordered_map>
+
+typedef std::tr1::unordered_map<uint64_t, void*> MapType;
+
+// same layout and shard choice as ShardedRWLock in ObjectAccessor.h
+enum { SHARD_COUNT = 16 };
+
+struct Shard
+{
+    pthread_rwlock_t lock;
+    char pad[64];
+};
+
+static Shard            g_shards[SHARD_COUNT];
+static pthread_rwlock_t g_single;
+static MapType          g_map;
+static bool             g_sharded = false;
+static volatile bool    g_stop = false;
+static uint32_t         g_objects = 20000;
+
+static uint32_t ReaderShard()
+{
+    size_t id = size_t(pthread_self());
+    return uint32_t(((id >> 12) ^ (id >> 2)) % SHARD_COUNT);
+}
+
+static void* Find(uint64_t guid, uint32_t shard)
+{
+    pthread_rwlock_t* lock = g_sharded ? &g_shards[shard].lock : &g_single;
+    pthread_rwlock_rdlock(lock);
+    MapType::const_iterator itr = g_map.find(guid);
+    void* res = itr != g_map.end() ? itr->second : NULL;
+    pthread_rwlock_unlock(lock);
+    return res;
+}
+
+static void LockWrite()
+{
+    if (!g_sharded)
+    {
+        pthread_rwlock_wrlock(&g_single);
+        return;
+    }
+    for (uint32_t i = 0; i < SHARD_COUNT; ++i)
+        pthread_rwlock_wrlock(&g_shards[i].lock);
+}
+
+static void UnlockWrite()
+{
+    if (!g_sharded)
+    {
+        pthread_rwlock_unlock(&g_single);
+        return;
+    }
+    for (uint32_t i = SHARD_COUNT; i > 0; --i)
+        pthread_rwlock_unlock(&g_shards[i - 1].lock);
+}
+
+struct Result
+{
+    uint64_t ops;
+    uint64_t hits;
+};
+
+static void* ReaderThread(void* arg)
+{
+    Result* res = (Result*)arg;
+    uint32_t shard = ReaderShard();             // the guard computes this once per lookup too
+    uint64_t seed = uint64_t(size_t(arg)) | 1;
+    while (!g_stop)
+    {
+        for (int i = 0; i < 1024; ++i)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (Find((seed >> 33) % (g_objects * 2), shard))
+                ++res->hits;
+        }
+        res->ops += 1024;
+    }
+    return NULL;
+}
+
+static void* WriterThread(void* arg)
+{
+    Result* res = (Result*)arg;
+    uint64_t guid = g_objects;
+    while (!g_stop)
+    {
+        // respawn churn: one insert and one remove, then let the readers run
+        LockWrite();
+        g_map[guid + g_objects] = (void*)1;
+        g_map.erase(guid);
+        UnlockWrite();
+        ++guid;
+        res->ops += 2;
+        usleep(50);
+    }
+    return NULL;
+}
+
+static double Now()
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void Run(bool sharded, int threads, int seconds)
+{
+    g_sharded = sharded;
+    g_stop = false;
+    g_map.clear();
+    for (uint32_t i = 0; i < g_objects * 2; ++i)
+        g_map[i] = (void*)1;
+
+    pthread_t* readers = new pthread_t[threads];
+    Result* results = new Result[threads + 1];
+    for (int i = 0; i <= threads; ++i)
+        results[i].ops = results[i].hits = 0;
+
+    pthread_t writer;
+    double start = Now();
+    for (int i = 0; i < threads; ++i)
+        pthread_create(&readers[i], NULL, ReaderThread, &results[i]);
+    pthread_create(&writer, NULL, WriterThread, &results[threads]);
+
+    sleep(seconds);
+    g_stop = true;
+
+    for (int i = 0; i < threads; ++i)
+        pthread_join(readers[i], NULL);
+    pthread_join(writer, NULL);
+    double elapsed = Now() - start;
+
+    uint64_t lookups = 0;
+    for (int i = 0; i < threads; ++i)
+        lookups += results[i].ops;
+
+    printf("%-8s threads %2d: %8.2f M lookups/s, %6.1f ns/lookup/thread, %7.0f writes/s\n",
+        sharded ? "sharded" : "single", threads, lookups / elapsed / 1e6,
+        elapsed * threads * 1e9 / double(lookups), results[threads].ops / elapsed);
+
+    delete[] readers;
+    delete[] results;
+}
+
+int main(int argc, char** argv)
+{
+    int threads = argc > 1 ? atoi(argv[1]) : int(sysconf(_SC_NPROCESSORS_ONLN));
+    int seconds = argc > 2 ? atoi(argv[2]) : 3;
+    if (argc > 3)
+        g_objects = atoi(argv[3]);
+    if (threads < 1)
+        threads = 1;
+
+    pthread_rwlock_init(&g_single, NULL);
+    for (int i = 0; i < SHARD_COUNT; ++i)
+        pthread_rwlock_init(&g_shards[i].lock, NULL);
+
+    printf("%u live objects, %ld cores\n", g_objects, sysconf(_SC_NPROCESSORS_ONLN));
+    for (int t = 1; t <= threads; t *= 2)
+    {
+        Run(false, t, seconds);
+        Run(true, t, seconds);
+    }
+    return 0;
+}
@@ -23,12 +23,22 @@
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_cursor = 0;
+    m_slots = NULL;
+    m_farSlots = NULL;
+    m_overflow = NULL;
+    m_wheelCount = 0;
+    m_farCount = 0;
+    m_sequence = 0;
+    m_slotSorted = true;
     m_aborting = false;
 }
 
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+    delete[] m_slots;
+    delete[] m_farSlots;
 }
 
 void EventProcessor::Update(uint32 p_time)
@@ -36,14 +46,13 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
+    // nothing scheduled, keep idle owners cheap
+    if (Empty())
+        return;
+
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (BasicEvent* Event = PopDueEvent())
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
-
         if (!Event->to_Abort)
         {
             if (Event->Execute(m_time, p_time))
@@ -65,33 +74,33 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
-    {
-        EventList::iterator i_old = i;
-        ++i;
+    std::vector<BasicEvent*> events;
+    CollectEvents(events);
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if(force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
+    // give the wheels back, the kept events allocate new ones
+    delete[] m_slots;
+    m_slots = NULL;
+    delete[] m_farSlots;
+    m_farSlots = NULL;
 
-            if(!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
-        }
+    // first, abort all existing events
+    for (std::vector<BasicEvent*>::iterator i = events.begin(); i != events.end(); ++i)
+    {
+        BasicEvent* Event = *i;
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
+            delete Event;
+        else                                                // keep for later cleanup
+            Schedule(Event);
     }
-
-    // fast clear event list (in force case)
-    if(force)
-        m_events.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     if (set_addtime) Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Schedule(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
@@ -99,3 +108,227 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset)
     return(m_time + t_offset);
 }
 
+void EventProcessor::Schedule(BasicEvent* Event)
+{
+    // the cursor stood still while nothing was scheduled, catch up with the current time
+    if (Empty())
+    {
+        m_cursor = m_time - m_time % EVENT_WHEEL_SLOT_TIME;
+        m_slotSorted = false;
+    }
+
+    Event->m_sequence = m_sequence++;
+    Link(Event);
+}
+
+// puts the event in front of the slot list its execution time belongs to, O(1)
+void EventProcessor::Link(BasicEvent* Event)
+{
+    // events already due go to the current slot
+    uint64 slotTime = Event->m_execTime < m_cursor ? m_cursor : Event->m_execTime;
+    uint64 delay = slotTime - m_cursor;
+
+    BasicEvent** link;
+    if (delay < EVENT_WHEEL_HORIZON)
+    {
+        if (!m_slots)
+        {
+            m_slots = new BasicEvent*[EVENT_WHEEL_SIZE];
+            for (uint32 i = 0; i < EVENT_WHEEL_SIZE; ++i)
+                m_slots[i] = NULL;
+        }
+        uint32 slot = (slotTime / EVENT_WHEEL_SLOT_TIME) % EVENT_WHEEL_SIZE;
+        if (slot == (m_cursor / EVENT_WHEEL_SLOT_TIME) % EVENT_WHEEL_SIZE)
+            m_slotSorted = false;
+        link = &m_slots[slot];
+        ++m_wheelCount;
+    }
+    else if (delay < EVENT_WHEEL_FAR_HORIZON)
+    {
+        if (!m_farSlots)
+        {
+            m_farSlots = new BasicEvent*[EVENT_WHEEL_SIZE];
+            for (uint32 i = 0; i < EVENT_WHEEL_SIZE; ++i)
+                m_farSlots[i] = NULL;
+        }
+        link = &m_farSlots[(slotTime / EVENT_WHEEL_HORIZON) % EVENT_WHEEL_SIZE];
+        ++m_farCount;
+    }
+    else
+    {
+        link = &m_overflow;
+        ++m_farCount;
+    }
+
+    Event->m_nextEvent = *link;
+    *link = Event;
+}
+
+BasicEvent* EventProcessor::PopDueEvent()
+{
+    while (true)
+    {
+        if (!m_wheelCount)
+        {
+            if (!m_farCount)
+                return NULL;
+
+            // nothing in the near wheel, skip its empty slots up to the next cascade
+            uint64 next = m_cursor - m_cursor % EVENT_WHEEL_HORIZON + EVENT_WHEEL_HORIZON;
+            if (next > m_time)
+                return NULL;
+            AdvanceCursor(next);
+            continue;
+        }
+
+        if (!m_slotSorted)
+            SortCurrentSlot();
+
+        BasicEvent*& head = m_slots[(m_cursor / EVENT_WHEEL_SLOT_TIME) % EVENT_WHEEL_SIZE];
+        if (head && head->m_execTime <= m_time)
+        {
+            BasicEvent* Event = head;
+            head = Event->m_nextEvent;
+            Event->m_nextEvent = NULL;
+            --m_wheelCount;
+            return Event;
+        }
+
+        // the current slot still holds (or may get) events not due yet
+        if (head || m_cursor + EVENT_WHEEL_SLOT_TIME > m_time)
+            return NULL;
+
+        AdvanceCursor(m_cursor + EVENT_WHEEL_SLOT_TIME);
+    }
+}
+
+void EventProcessor::AdvanceCursor(uint64 cursor)
+{
+    m_cursor = cursor;
+    m_slotSorted = false;
+
+    if (m_cursor % EVENT_WHEEL_HORIZON)
+        return;
+
+    // entering a new far slot: its events now fall into the near wheel
+    if (m_farSlots)
+    {
+        BasicEvent*& far = m_farSlots[(m_cursor / EVENT_WHEEL_HORIZON) % EVENT_WHEEL_SIZE];
+        BasicEvent* list = far;
+        far = NULL;
+        Cascade(list);
+    }
+
+    // once per far wheel turn the overflow moves closer
+    if (m_overflow && m_cursor % EVENT_WHEEL_FAR_HORIZON == 0)
+    {
+        BasicEvent* list = m_overflow;
+        m_overflow = NULL;
+        Cascade(list);
+    }
+}
+
+void EventProcessor::Cascade(BasicEvent* list)
+{
+    while (list)
+    {
+        BasicEvent* Event = list;
+        list = Event->m_nextEvent;
+        --m_farCount;
+        Link(Event);
+    }
+}
+
+// stable merge sort of the current slot by execution time, then insertion order
+void EventProcessor::SortCurrentSlot()
+{
+    m_slotSorted = true;
+
+    BasicEvent*& head = m_slots[(m_cursor / EVENT_WHEEL_SLOT_TIME) % EVENT_WHEEL_SIZE];
+    if (!head || !head->m_nextEvent)
+        return;
+
+    for (uint32 width = 1;; width *= 2)
+    {
+        BasicEvent* rest = head;
+        BasicEvent** tail = &head;
+        uint32 merges = 0;
+
+        while (rest)
+        {
+            ++merges;
+
+            // split off two runs of up to width events
+            BasicEvent* left = rest;
+            uint32 leftSize = 0;
+            while (rest && leftSize < width)
+            {
+                rest = rest->m_nextEvent;
+                ++leftSize;
+            }
+            BasicEvent* right = rest;
+            uint32 rightSize = 0;
+            while (rest && rightSize < width)
+            {
+                rest = rest->m_nextEvent;
+                ++rightSize;
+            }
+
+            while (leftSize || rightSize)
+            {
+                bool takeLeft;
+                if (!rightSize)
+                    takeLeft = true;
+                else if (!leftSize)
+                    takeLeft = false;
+                else if (left->m_execTime != right->m_execTime)
+                    takeLeft = left->m_execTime < right->m_execTime;
+                else
+                    takeLeft = int32(left->m_sequence - right->m_sequence) < 0;
+
+                BasicEvent*& from = takeLeft ? left : right;
+                *tail = from;
+                tail = &from->m_nextEvent;
+                from = from->m_nextEvent;
+                --(takeLeft ? leftSize : rightSize);
+            }
+        }
+        *tail = NULL;
+
+        if (merges <= 1)
+            return;
+    }
+}
+
+void EventProcessor::CollectEvents(std::vector<BasicEvent*>& events)
+{
+    events.reserve(m_wheelCount + m_farCount);
+
+    BasicEvent** lists[2] = { m_slots, m_farSlots };
+    for (uint32 l = 0; l < 2; ++l)
+    {
+        for (uint32 i = 0; lists[l] && i < EVENT_WHEEL_SIZE; ++i)
+        {
+            for (BasicEvent* Event = lists[l][i]; Event;)
+            {
+                BasicEvent* next = Event->m_nextEvent;
+                Event->m_nextEvent = NULL;
+                events.push_back(Event);
+                Event = next;
+            }
+            lists[l][i] = NULL;
+        }
+    }
+
+    for (BasicEvent* Event = m_overflow; Event;)
+    {
+        BasicEvent* next = Event->m_nextEvent;
+        Event->m_nextEvent = NULL;
+        events.push_back(Event);
+        Event = next;
+    }
+    m_overflow = NULL;
+
+    m_wheelCount = 0;
+    m_farCount = 0;
+}
@@ -24,13 +24,14 @@
 #include "Platform/Define.h"
 
 #include<map>
+#include<vector>
 
 // Note. All times are in milliseconds here.
 
 class BasicEvent
 {
     public:
-        BasicEvent() { to_Abort = false; }
+        BasicEvent() : m_nextEvent(NULL) { to_Abort = false; }
         virtual ~BasicEvent()                               // override destructor to perform some actions on event removal
         {
         };
@@ -50,10 +51,22 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+        uint32 m_sequence;                                  // orders events of equal m_execTime by insertion, filled by event handler
+
+        BasicEvent* m_nextEvent;                            // intrusive link of the event processor slot lists
 };
 
 typedef std::multimap<uint64, BasicEvent*> EventList;
 
+// hierarchical timing wheel: EVENT_WHEEL_SIZE slots of EVENT_WHEEL_SLOT_TIME ms each, then a far wheel
+// with slots of EVENT_WHEEL_HORIZON ms each that cascades into the first one, then an overflow list
+// checked once per far wheel turn. Slots are unordered, an event is only put in order when its slot fires.
+// Each wheel is allocated at its first event, so processors of units that never get one stay small.
+#define EVENT_WHEEL_SLOT_TIME   16
+#define EVENT_WHEEL_SIZE        64
+#define EVENT_WHEEL_HORIZON     (EVENT_WHEEL_SLOT_TIME * EVENT_WHEEL_SIZE)
+#define EVENT_WHEEL_FAR_HORIZON (EVENT_WHEEL_HORIZON * EVENT_WHEEL_SIZE)
+
 class EventProcessor
 {
     public:
@@ -64,9 +77,25 @@ class EventProcessor
         void KillAllEvents(bool force);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset);
+        bool Empty() const { return !m_wheelCount && !m_farCount; }
     protected:
+        void Schedule(BasicEvent* Event);
+        void Link(BasicEvent* Event);
+        BasicEvent* PopDueEvent();
+        void AdvanceCursor(uint64 cursor);
+        void Cascade(BasicEvent* list);
+        void SortCurrentSlot();
+        void CollectEvents(std::vector<BasicEvent*>& events);
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_cursor;                                    // start time of the current wheel slot
+        BasicEvent** m_slots;                               // unordered event lists of the next EVENT_WHEEL_HORIZON ms, NULL until needed
+        BasicEvent** m_farSlots;                            // unordered event lists up to EVENT_WHEEL_FAR_HORIZON ms, NULL until needed
+        BasicEvent* m_overflow;                             // unordered events beyond the far wheel
+        uint32 m_wheelCount;                                // events in m_slots
+        uint32 m_farCount;                                  // events in m_farSlots and m_overflow
+        uint32 m_sequence;
+        bool m_slotSorted;                                  // the current slot is in execution order
         bool m_aborting;
 };
 #endif
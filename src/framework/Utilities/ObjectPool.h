@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2008 Neo <http://www.neocore.info/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef __OBJECTPOOL_H
+#define __OBJECTPOOL_H
+
+#include "Platform/Define.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+// max. number of released objects kept per thread and type
+#define OBJECT_POOL_THREAD_CACHE_SIZE 1024
+
+struct ObjectPoolStats
+{
+    ObjectPoolStats() : allocated(0), reused(0), inUse(0), cached(0) {}
+
+    void Add(ObjectPoolStats const& o)
+    {
+        allocated += o.allocated;
+        reused += o.reused;
+        inUse += o.inUse;
+        cached += o.cached;
+    }
+
+    long allocated;                                         // taken from the global allocator
+    long reused;                                            // served from a thread cache
+    long inUse;
+    long cached;
+};
+
+/*
+ * Recycles the memory of frequently created and destroyed objects of type T.
+ * Every thread keeps its own cache of released blocks, so map threads never contend.
+ * A block released on another thread than it was allocated on just moves to that thread's cache.
+ * Only blocks of exactly sizeof(T) are pooled, derived classes use the global allocator.
+ * The counters live in the thread caches too and are only summed up by GetStats(), which reads
+ * them unlocked while their threads go on, so the totals are a close snapshot, not an exact one.
+ *
+ * Usage: put DECLARE_OBJECT_POOL(T) into a public section of T.
+ */
+template<class T>
+class ObjectPool
+{
+    public:
+        static void* Allocate(size_t size)
+        {
+            if (size == sizeof(T))
+            {
+                if (ThreadCache* cache = GetCache())
+                {
+                    ++cache->stats.inUse;
+                    if (!cache->blocks.empty())
+                    {
+                        void* p = cache->blocks.back();
+                        cache->blocks.pop_back();
+                        --cache->stats.cached;
+                        ++cache->stats.reused;
+                        return p;
+                    }
+                    ++cache->stats.allocated;
+                }
+            }
+            return ::operator new(size);
+        }
+
+        static void Release(void* p, size_t size)
+        {
+            if (!p)
+                return;
+            if (size == sizeof(T))
+            {
+                if (ThreadCache* cache = GetCache())
+                {
+                    --cache->stats.inUse;                   // may go negative when other threads allocated, only the sum counts
+                    if (cache->blocks.size() < OBJECT_POOL_THREAD_CACHE_SIZE)
+                    {
+                        cache->blocks.push_back(p);
+                        ++cache->stats.cached;
+                        return;
+                    }
+                }
+            }
+            ::operator delete(p);
+        }
+
+        // sums the counters of all thread caches, including those of exited threads
+        static ObjectPoolStats GetStats()
+        {
+            Registry& registry = GetRegistry();
+            ACE_Guard<ACE_Thread_Mutex> guard(registry.lock);
+            ObjectPoolStats stats = registry.retired;
+            for (typename std::vector<ThreadCache*>::const_iterator itr = registry.caches.begin(); itr != registry.caches.end(); ++itr)
+                stats.Add((*itr)->stats);
+            return stats;
+        }
+
+    private:
+        struct ThreadCache
+        {
+            ThreadCache()
+            {
+                Registry& registry = GetRegistry();
+                ACE_Guard<ACE_Thread_Mutex> guard(registry.lock);
+                registry.caches.push_back(this);
+            }
+
+            ~ThreadCache()
+            {
+                for (size_t i = 0; i < blocks.size(); ++i)
+                    ::operator delete(blocks[i]);
+                stats.cached -= long(blocks.size());
+
+                Registry& registry = GetRegistry();
+                ACE_Guard<ACE_Thread_Mutex> guard(registry.lock);
+                registry.caches.erase(std::find(registry.caches.begin(), registry.caches.end(), this));
+                registry.retired.Add(stats);
+            }
+
+            std::vector<void*> blocks;
+            ObjectPoolStats stats;                          // only written by the owning thread
+        };
+
+        // all live thread caches, the lock is taken once per thread and by GetStats()
+        struct Registry
+        {
+            ACE_Thread_Mutex lock;
+            std::vector<ThreadCache*> caches;
+            ObjectPoolStats retired;                        // counters of exited threads
+        };
+
+        static ThreadCache* GetCache() { return m_cache ? (ThreadCache*)(*m_cache) : NULL; }
+
+        // created on first use and never destroyed, thread caches may go away during static destruction
+        static Registry& GetRegistry()
+        {
+            static Registry* registry = new Registry();
+            return *registry;
+        }
+
+        // never destroyed, objects may still be released during static destruction
+        static ACE_TSS<ThreadCache>* m_cache;
+};
+
+template<class T> ACE_TSS<typename ObjectPool<T>::ThreadCache>* ObjectPool<T>::m_cache = new ACE_TSS<typename ObjectPool<T>::ThreadCache>();
+
+#define DECLARE_OBJECT_POOL(T) \
+        static void* operator new(size_t size) { return ObjectPool<T>::Allocate(size); } \
+        static void operator delete(void* p, size_t size) { ObjectPool<T>::Release(p, size); } \
+        static void* operator new(size_t, void* where) { return where; } \
+        static void operator delete(void*, void*) {}
+
+#endif
@@ -46,7 +46,7 @@ INSTANTIATE_SINGLETON_1(BattleGroundMgr);
 /***            BATTLEGROUND QUEUE SYSTEM              ***/
 /*********************************************************/
 
-BattleGroundQueue::BattleGroundQueue()
+BattleGroundQueue::BattleGroundQueue() : m_NextQueuePos(0)
 {
     //queues are empty, we don't have to call clear()
 /*    for (int i = 0; i < MAX_BATTLEGROUND_QUEUES; i++)
@@ -152,10 +152,13 @@ GroupQueueInfo * BattleGroundQueue::AddGroup(Player *leader, uint32 BgTypeId, ui
     ginfo->Team                      = leader->GetTeam();
     ginfo->ArenaTeamRating           = arenaRating;
     ginfo->OpponentsTeamRating       = 0;                       //initialize it to 0
+    ginfo->QueuePos                  = m_NextQueuePos++;
 
     ginfo->Players.clear();
 
     m_QueuedGroups[queue_id].push_back(ginfo);
+    if (isRated)
+        IndexRatedGroup(queue_id, ginfo);
 
     // return ginfo, because it is needed to add players to this group info
     return ginfo;
@@ -277,6 +280,8 @@ void BattleGroundQueue::RemovePlayer(uint64 guid, bool decreaseInvitedCount)
         if (group->Players.empty())
         {
             m_QueuedGroups[queue_id].erase(group_itr);
+            if (group->IsRated)
+                UnindexRatedGroup(queue_id, group);
             delete group;
         }
         // NEEDS TESTING!
@@ -311,6 +316,9 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround * b
     if (!ginfo->IsInvitedToBGInstanceGUID)
     {
         // not yet invited
+        // invited groups are never matched again
+        if (ginfo->IsRated)
+            UnindexRatedGroup(bg->GetQueueType(), ginfo);
         // set invitation
         ginfo->IsInvitedToBGInstanceGUID = bg->GetInstanceID();
         uint32 bgQueueTypeId = sBattleGroundMgr.BGQueueTypeId(bg->GetTypeID(), bg->GetArenaType());
@@ -398,6 +406,19 @@ bool BattleGroundQueue::BuildSelectionPool(uint32 bgTypeId, uint32 queue_id, uin
         break;
     }
 
+    // rated arena teams always fill a whole side, so the pool is just the team EligibleGroups would list first
+    if (isRated && MinPlayers == MaxPlayers)
+    {
+        m_SelectionPools[mode].Init(&m_EligibleGroups);
+        if (GroupQueueInfo* ginfo = SelectRatedGroup(bgTypeId, queue_id, side, MaxPlayers, ArenaType, MinRating, MaxRating, DisregardTime, excludeTeam))
+        {
+            m_SelectionPools[mode].AddGroup(ginfo);
+            sLog.outDebug("Battleground-debug: rated pool for mode %u selected arena team %u (rating %u)", mode, ginfo->ArenaTeamId, ginfo->ArenaTeamRating);
+            return true;
+        }
+        return false;
+    }
+
     // initiate the groups eligible to create the bg
     m_EligibleGroups.Init(&(m_QueuedGroups[queue_id]), bgTypeId, side, MaxPlayers, ArenaType, isRated, MinRating, MaxRating, DisregardTime, excludeTeam);
     // init the selected groups (clear)
@@ -422,6 +443,101 @@ bool BattleGroundQueue::BuildSelectionPool(uint32 bgTypeId, uint32 queue_id, uin
     return false;
 }
 
+void BattleGroundQueue::IndexRatedGroup(uint32 queue_id, GroupQueueInfo* ginfo)
+{
+    RatedGroupIndex& index = m_RatedGroups[queue_id][ginfo->Team == ALLIANCE ? BG_TEAM_ALLIANCE : BG_TEAM_HORDE];
+    index.ByJoin.insert(ginfo);
+    if (ginfo->ArenaTeamRating == 0)
+        index.NoRating.insert(ginfo);
+    else
+        index.ByRating[ginfo->ArenaTeamRating / BATTLEGROUND_QUEUE_RATING_BUCKET].insert(ginfo);
+}
+
+void BattleGroundQueue::UnindexRatedGroup(uint32 queue_id, GroupQueueInfo* ginfo)
+{
+    if (queue_id >= MAX_BATTLEGROUND_QUEUES)
+        return;
+
+    // the group's Team may have been changed for one faction arenas, so look at both sides
+    for (int side = 0; side < 2; ++side)
+    {
+        RatedGroupIndex& index = m_RatedGroups[queue_id][side];
+        if (!index.ByJoin.erase(ginfo))
+            continue;
+
+        if (ginfo->ArenaTeamRating == 0)
+            index.NoRating.erase(ginfo);
+        else
+        {
+            RatingBuckets::iterator bucket = index.ByRating.find(ginfo->ArenaTeamRating / BATTLEGROUND_QUEUE_RATING_BUCKET);
+            if (bucket != index.ByRating.end())
+            {
+                bucket->second.erase(ginfo);
+                if (bucket->second.empty())
+                    index.ByRating.erase(bucket);
+            }
+        }
+    }
+}
+
+// returns the group EligibleGroups::Init() would put first for these arguments, from the rating index
+GroupQueueInfo* BattleGroundQueue::SelectRatedGroup(uint32 bgTypeId, uint32 queue_id, uint32 side, uint32 MaxPlayers, uint8 ArenaType, uint32 MinRating, uint32 MaxRating, uint32 DisregardTime, uint32 excludeTeam) const
+{
+    RatedGroupIndex const& index = m_RatedGroups[queue_id][side == ALLIANCE ? BG_TEAM_ALLIANCE : BG_TEAM_HORDE];
+    GroupQueueInfo* best = NULL;
+
+    #define IS_RATED_CANDIDATE(g) ((g)->BgTypeId == bgTypeId && (g)->ArenaType == ArenaType && (g)->Team == side && \
+        (g)->Players.size() == MaxPlayers && (!excludeTeam || (g)->ArenaTeamId != excludeTeam))
+
+    // teams that joined before the discard time (or all, without one) match whatever their rating is
+    for (RatedGroupSet::const_iterator itr = index.ByJoin.begin(); itr != index.ByJoin.end(); ++itr)
+    {
+        if (DisregardTime && (*itr)->JoinTime > DisregardTime)
+            break;
+        if (IS_RATED_CANDIDATE(*itr))
+        {
+            best = *itr;
+            break;
+        }
+    }
+
+    // nothing can be older than that
+    if (best)
+        return best;
+
+    for (RatedGroupSet::const_iterator itr = index.NoRating.begin(); itr != index.NoRating.end(); ++itr)
+    {
+        if (IS_RATED_CANDIDATE(*itr))
+        {
+            best = *itr;
+            break;
+        }
+    }
+
+    // oldest team within the rating window, only the border buckets hold teams outside of it
+    if (MaxRating)
+    {
+        RatingBuckets::const_iterator end = index.ByRating.upper_bound(MaxRating / BATTLEGROUND_QUEUE_RATING_BUCKET);
+        for (RatingBuckets::const_iterator bucket = index.ByRating.lower_bound(MinRating / BATTLEGROUND_QUEUE_RATING_BUCKET); bucket != end; ++bucket)
+        {
+            for (RatedGroupSet::const_iterator itr = bucket->second.begin(); itr != bucket->second.end(); ++itr)
+            {
+                if (best && best->QueuePos < (*itr)->QueuePos)
+                    break;                                  // rest of the bucket joined even later
+                if ((*itr)->ArenaTeamRating >= MinRating && (*itr)->ArenaTeamRating <= MaxRating && IS_RATED_CANDIDATE(*itr))
+                {
+                    best = *itr;
+                    break;
+                }
+            }
+        }
+    }
+
+    #undef IS_RATED_CANDIDATE
+
+    return best;
+}
+
 // used to remove the Enter Battle window if the battle has already, but someone still has it
 // (this can happen in arenas mainly, since the preparation is shorter than the timer for the bgqueueremove event
 void BattleGroundQueue::BGEndedRemoveInvites(BattleGround *bg)
@@ -40,6 +40,8 @@ typedef std::deque<BattleGround*> BGFreeSlotQueueType;
 
 #define BATTLEGROUND_ARENA_POINT_DISTRIBUTION_DAY    86400     // seconds in a day
 
+#define BATTLEGROUND_QUEUE_RATING_BUCKET 50                 // width of the rating buckets rated arena teams are queued in
+
 struct GroupQueueInfo;                                      // type predefinition
 struct PlayerQueueInfo                                      // stores information for players in queue
 {
@@ -61,6 +63,12 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  IsInvitedToBGInstanceGUID;                      // was invited to certain BG
     uint32  ArenaTeamRating;                                // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
+    uint32  QueuePos;                                       // increases with every group joining the queue
+};
+
+struct GroupQueueInfoJoinOrder                              // orders queued groups the way they joined
+{
+    bool operator() (GroupQueueInfo const* a, GroupQueueInfo const* b) const { return a->QueuePos < b->QueuePos; }
 };
 
 class BattleGround;
@@ -128,6 +136,22 @@ class BattleGroundQueue
     private:
 
         bool InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround * bg, uint32 side);
+
+        // Uninvited rated groups of a queue and side, so rated arena matching doesn't walk the whole queue
+        typedef std::set<GroupQueueInfo*, GroupQueueInfoJoinOrder> RatedGroupSet;
+        typedef std::map<uint32, RatedGroupSet> RatingBuckets;
+        struct RatedGroupIndex
+        {
+            RatedGroupSet ByJoin;                           // all of them, oldest first
+            RatedGroupSet NoRating;                         // rating 0, they match everyone
+            RatingBuckets ByRating;                         // rating / BATTLEGROUND_QUEUE_RATING_BUCKET -> groups
+        };
+        RatedGroupIndex m_RatedGroups[MAX_BATTLEGROUND_QUEUES][2];
+        uint32 m_NextQueuePos;
+
+        void IndexRatedGroup(uint32 queue_id, GroupQueueInfo* ginfo);
+        void UnindexRatedGroup(uint32 queue_id, GroupQueueInfo* ginfo);
+        GroupQueueInfo* SelectRatedGroup(uint32 bgTypeId, uint32 queue_id, uint32 side, uint32 MaxPlayers, uint8 ArenaType, uint32 MinRating, uint32 MaxRating, uint32 DisregardTime, uint32 excludeTeam) const;
 };
 
 /*
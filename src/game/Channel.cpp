@@ -106,10 +106,7 @@ void Channel::Join(uint64 p, const char *pass)
 
     data.clear();
 
-    PlayerInfo pinfo;
-    pinfo.player = p;
-    pinfo.flags = 0;
-    players[p] = pinfo;
+    AddPlayer(p, plr);
 
     MakeYouJoined(&data);
     SendToOne(&data, p);
@@ -151,7 +148,7 @@ void Channel::Leave(uint64 p, bool send)
 
         bool changeowner = players[p].IsOwner();
 
-        players.erase(p);
+        RemovePlayer(p);
         if (m_announce && (!plr || plr->GetSession()->GetSecurity() < SEC_GAMEMASTER || !sWorld.getConfig(CONFIG_SILENTLY_GM_JOIN_TO_CHANNEL) ))
         {
             WorldPacket data;
@@ -218,7 +215,7 @@ void Channel::KickOrBan(uint64 good, const char *badname, bool ban)
                 MakePlayerKicked(&data, bad->GetGUID(), good);
 
             SendToAll(&data);
-            players.erase(bad->GetGUID());
+            RemovePlayer(bad->GetGUID());
             bad->LeftChannel(this);
 
             if (changeowner)
@@ -660,30 +657,54 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
     }
 }
 
-void Channel::SendToAll(WorldPacket *data, uint64 p)
+void Channel::AddPlayer(uint64 p, Player* plr)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    PlayerInfo pinfo;
+    pinfo.player = p;
+
+    if (plr)
     {
-        Player *plr = objmgr.GetPlayer(i->first);
-        if (plr)
-        {
-            if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                plr->GetSession()->SendPacket(data);
-        }
+        pinfo.member = members.size();
+        members.push_back(plr);
     }
+
+    players[p] = pinfo;
 }
 
-void Channel::SendToAllButOne(WorldPacket *data, uint64 who)
+void Channel::RemovePlayer(uint64 p)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    PlayerList::iterator itr = players.find(p);
+    if (itr == players.end())
+        return;
+
+    uint32 slot = itr->second.member;
+    players.erase(itr);
+
+    if (slot == CHANNEL_NO_MEMBER_SLOT)
+        return;
+
+    // move the last member into the free slot
+    if (slot + 1 != members.size())
     {
-        if (i->first != who)
-        {
-            Player *plr = objmgr.GetPlayer(i->first);
-            if (plr)
-                plr->GetSession()->SendPacket(data);
-        }
+        members[slot] = members.back();
+        players[members[slot]->GetGUID()].member = slot;
     }
+    members.pop_back();
+}
+
+// the packet is built once and copied into every socket's send buffer, no per member lookups or packet copies
+void Channel::SendToAll(WorldPacket *data, uint64 p)
+{
+    for (MemberList::const_iterator i = members.begin(); i != members.end(); ++i)
+        if (!p || !(*i)->GetSocial()->HasIgnore(GUID_LOPART(p)))
+            (*i)->GetSession()->SendPacket(data);
+}
+
+void Channel::SendToAllButOne(WorldPacket *data, uint64 who)
+{
+    for (MemberList::const_iterator i = members.begin(); i != members.end(); ++i)
+        if ((*i)->GetGUID() != who)
+            (*i)->GetSession()->SendPacket(data);
 }
 
 void Channel::SendToOne(WorldPacket *data, uint64 who)
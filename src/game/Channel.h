@@ -30,6 +30,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 enum ChatNotify
 {
@@ -118,12 +119,17 @@ enum ChannelMemberFlags
     // 0x80
 };
 
+#define CHANNEL_NO_MEMBER_SLOT 0xFFFFFFFF
+
 class Channel
 {
     struct PlayerInfo
     {
         uint64 player;
         uint8 flags;
+        uint32 member;                                      // position in members, CHANNEL_NO_MEMBER_SLOT if not online at join
+
+        PlayerInfo() : player(0), flags(0), member(CHANNEL_NO_MEMBER_SLOT) {}
 
         bool HasFlag(uint8 flag) { return flags & flag; }
         void SetFlag(uint8 flag) { if (!HasFlag(flag)) flags |= flag; }
@@ -149,6 +155,8 @@ class Channel
 
     typedef     std::map<uint64, PlayerInfo> PlayerList;
     PlayerList  players;
+    typedef     std::vector<Player*> MemberList;
+    MemberList  members;                                    // dense list of the online players, broadcasts walk this
     typedef     std::set<uint64> BannedList;
     BannedList  banned;
     bool        m_announce;
@@ -200,6 +208,10 @@ class Channel
         void MakeVoiceOn(WorldPacket *data, uint64 guid);                       //+ 0x22
         void MakeVoiceOff(WorldPacket *data, uint64 guid);                      //+ 0x23
 
+        // players are added and removed together with their members slot, the Player* stays valid until Leave()
+        void AddPlayer(uint64 p, Player* plr);
+        void RemovePlayer(uint64 p);
+
         void SendToAll(WorldPacket *data, uint64 p = 0);
         void SendToAllButOne(WorldPacket *data, uint64 who);
         void SendToOne(WorldPacket *data, uint64 who);
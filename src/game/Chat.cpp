@@ -210,6 +210,8 @@ ChatCommand * ChatHandler::getCommandTable()
         { "arena",          SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugArenaCommand,          "", NULL },
         { "bg",             SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugBattlegroundCommand,   "", NULL },
         { "threatlist",     SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugThreatList,            "", NULL },
+        { "pools",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPoolsCommand,          "", NULL },
+        { "lootgroup",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugLootGroupCommand,      "", NULL },
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
@@ -497,6 +497,8 @@ class ChatHandler
         bool HandleDebugBattlegroundCommand(const char * args);
         bool HandleDebugThreatList(const char * args);
         bool HandleDebugHostilRefList(const char * args);
+        bool HandleDebugPoolsCommand(const char * args);
+        bool HandleDebugLootGroupCommand(const char * args);
         bool HandlePossessCommand(const char* args);
         bool HandleUnPossessCommand(const char* args);
         bool HandleBindSightCommand(const char* args);
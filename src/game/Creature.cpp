@@ -143,13 +143,14 @@ Creature::Creature() :
 Unit(),
 lootForPickPocketed(false), lootForBody(false), m_lootMoney(0), m_lootRecipient(0),
 m_deathTimer(0), m_respawnTime(0), m_respawnDelay(25), m_corpseDelay(60), m_respawnradius(0.0f),
-m_gossipOptionLoaded(false), m_emoteState(0), m_isPet(false), m_isTotem(false), m_reactState(REACT_AGGRESSIVE),
+m_gossipOptionLoaded(false), m_emoteState(0), m_isPet(false), m_isTotem(false), m_isTemporarySummon(false), m_reactState(REACT_AGGRESSIVE),
 m_regenTimer(2000), m_defaultMovementType(IDLE_MOTION_TYPE), m_equipmentId(0), m_AlreadyCallAssistance(false),
 m_regenHealth(true), m_AI_locked(false), m_isDeadByDefault(false),
 m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL),m_creatureInfo(NULL), m_DBTableGuid(0), m_formation(NULL), m_PlayerDamageReq(0)
 , m_AlreadySearchedAssistance(false)
 {
     m_valuesCount = UNIT_END;
+    m_respawnScheduled = 0;
 
     for (int i =0; i<4; ++i)
         m_spells[i] = 0;
@@ -181,8 +182,11 @@ void Creature::AddToWorld()
     if (!IsInWorld())
     {
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->InsertObjectGuid(this);
         Unit::AddToWorld();
         SearchFormation();
+        if (m_deathState == DEAD)
+            GetMap()->ScheduleRespawn(this);
     }
 }
 
@@ -192,12 +196,16 @@ void Creature::RemoveFromWorld()
     if (IsInWorld())
     {
         if (Map *map = FindMap())
+        {
             if (map->IsDungeon() && ((InstanceMap*)map)->GetInstanceData())
                 ((InstanceMap*)map)->GetInstanceData()->OnCreatureRemove(this);
+            map->RemoveObjectGuid(this);
+        }
         if (m_formation)
             formation_mgr.RemoveCreatureFromGroup(m_formation, this);
         ObjectAccessor::Instance().RemoveObject(this);
         Unit::RemoveFromWorld();
+        m_respawnScheduled = 0;                             // the entry in the old map's schedule is stale now
     }
 }
 
@@ -224,6 +232,28 @@ void Creature::SearchFormation()
 
 }
 
+void Creature::UpdateRespawn()
+{
+    if (m_respawnTime > time(NULL))
+        return;
+
+    if (!GetLinkedCreatureRespawnTime()) // Can respawn
+        Respawn();
+    else // the master is dead
+    {
+        if (uint32 targetGuid = objmgr.GetLinkedRespawnGuid(m_DBTableGuid))
+        {
+            if (targetGuid == m_DBTableGuid) // if linking self, never respawn (check delayed to next day)
+                SetRespawnTime(DAY);
+            else
+                m_respawnTime = (time(NULL)>GetLinkedCreatureRespawnTime()? time(NULL):GetLinkedCreatureRespawnTime())+urand(5,MINUTE); // else copy time from master and add a little
+            SaveRespawnTime(); // also save to DB immediately
+        }
+        else
+            Respawn();
+    }
+}
+
 void Creature::RemoveCorpse()
 {
     if (getDeathState()!=CORPSE && !m_isDeadByDefault || getDeathState()!=ALIVE && m_isDeadByDefault )
@@ -232,7 +262,7 @@ void Creature::RemoveCorpse()
     m_deathTimer = 0;
     setDeathState(DEAD);
     ObjectAccessor::UpdateObjectVisibility(this);
-    loot.clear();
+    loot.release();                                         // corpse is gone, keep no loot storage until the next kill
     m_respawnTime = time(NULL) + m_respawnDelay;
 
     float x,y,z,o;
@@ -422,27 +452,8 @@ void Creature::Update(uint32 diff)
             sLog.outError("Creature (GUIDLow: %u Entry: %u ) in wrong state: JUST_DEAD (1)",GetGUIDLow(),GetEntry());
             break;
         case DEAD:
-        {
-            if (m_respawnTime <= time(NULL) )
-            {
-                if (!GetLinkedCreatureRespawnTime()) // Can respawn
-                    Respawn();
-                else // the master is dead
-                {
-                    if (uint32 targetGuid = objmgr.GetLinkedRespawnGuid(m_DBTableGuid))
-                    {
-                        if (targetGuid == m_DBTableGuid) // if linking self, never respawn (check delayed to next day)
-                            SetRespawnTime(DAY);
-                        else
-                            m_respawnTime = (time(NULL)>GetLinkedCreatureRespawnTime()? time(NULL):GetLinkedCreatureRespawnTime())+urand(5,MINUTE); // else copy time from master and add a little
-                        SaveRespawnTime(); // also save to DB immediately
-                    }
-                    else
-                        Respawn();
-                }
-            }
+            // respawn is driven by the respawn schedule of the map, see UpdateRespawn()
             break;
-        }
         case CORPSE:
         {
             if (m_isDeadByDefault)
@@ -1640,6 +1651,9 @@ void Creature::setDeathState(DeathState s)
 
     Unit::setDeathState(s);
 
+    if (s == DEAD && IsInWorld())
+        GetMap()->ScheduleRespawn(this);
+
     if (s == JUST_DIED)
     {
         SetUInt64Value (UNIT_FIELD_TARGET,0);               // remove target selection in any cases (can be set at aura remove in Unit::setDeathState)
@@ -2292,6 +2306,15 @@ bool Creature::HasSpell(uint32 spellID) const
     return i < CREATURE_MAX_SPELLS;                         //broke before end of iteration of known spells
 }
 
+void Creature::SetRespawnTime(uint32 respawn)
+{
+    m_respawnTime = respawn ? time(NULL) + respawn : 0;
+
+    // the respawn may have been moved earlier than the queued wake-up
+    if (m_deathState == DEAD && IsInWorld())
+        GetMap()->ScheduleRespawn(this);
+}
+
 time_t Creature::GetRespawnTimeEx() const
 {
     time_t now = time(NULL);
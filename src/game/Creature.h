@@ -29,6 +29,7 @@
 #include "Database/DatabaseEnv.h"
 #include "Cell.h"
 #include "CreatureGroups.h"
+#include "Utilities/ObjectPool.h"
 
 #include <list>
 
@@ -443,6 +444,8 @@ typedef std::map<uint32,time_t> CreatureSpellCooldowns;
 class NEO_DLL_SPEC Creature : public Unit
 {
     public:
+        DECLARE_OBJECT_POOL(Creature)
+
 
         explicit Creature();
         virtual ~Creature();
@@ -467,6 +470,7 @@ class NEO_DLL_SPEC Creature : public Unit
         bool isPet() const { return m_isPet; }
         void SetCorpseDelay(uint32 delay) { m_corpseDelay = delay; }
         bool isTotem() const { return m_isTotem; }
+        bool isTemporarySummon() const { return m_isTemporarySummon; }
         bool isRacialLeader() const { return GetCreatureInfo()->RacialLeader; }
         bool isCivilian() const { return GetCreatureInfo()->flags_extra & CREATURE_FLAG_EXTRA_CIVILIAN; }
         bool isTrigger() const { return GetCreatureInfo()->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER; }
@@ -632,8 +636,11 @@ class NEO_DLL_SPEC Creature : public Unit
 
         time_t const& GetRespawnTime() const { return m_respawnTime; }
         time_t GetRespawnTimeEx() const;
-        void SetRespawnTime(uint32 respawn) { m_respawnTime = respawn ? time(NULL) + respawn : 0; }
+        void SetRespawnTime(uint32 respawn);
         void Respawn();
+        void UpdateRespawn();                               // called by the map's respawn schedule once the respawn time passed
+
+        time_t m_respawnScheduled;                          // wake-up queued in the respawn schedule of the map, 0 if none
         void SaveRespawnTime();
 
         uint32 GetRespawnDelay() const { return m_respawnDelay; }
@@ -720,6 +727,7 @@ class NEO_DLL_SPEC Creature : public Unit
         uint8 m_emoteState;
         bool m_isPet;                                       // set only in Pet::Pet
         bool m_isTotem;                                     // set only in Totem::Totem
+        bool m_isTemporarySummon;                           // set only in TemporarySummon::TemporarySummon
         ReactStates m_reactState;                           // for AI, not charmInfo
         void RegenerateMana();
         void RegenerateHealth();
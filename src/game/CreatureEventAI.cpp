@@ -33,22 +33,83 @@
 #include "SpellMgr.h"
 #include "CreatureAIImpl.h"
 
-bool CreatureEventAIHolder::UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax )
+bool CreatureEventAI::UpdateRepeatTimer(CreatureEventAIHolder& holder, uint32 repeatMin, uint32 repeatMax)
 {
+    uint32 time;
     if (repeatMin == repeatMax)
-        Time = repeatMin;
+        time = repeatMin;
     else if (repeatMax > repeatMin)
-        Time = urand(repeatMin, repeatMax);
+        time = urand(repeatMin, repeatMax);
     else
     {
-        sLog.outErrorDb("CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", creature->GetEntry(), Event.event_id, Event.event_type);
-        Enabled = false;
+        sLog.outErrorDb("CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", m_creature->GetEntry(), holder.Event->event_id, holder.Event->event_type);
+        holder.Enabled = false;
         return false;
     }
 
+    SetEventTimer(holder, time);
     return true;
 }
 
+void CreatureEventAI::SetEventTimer(CreatureEventAIHolder& holder, uint32 time)
+{
+    holder.Time = EventClock + time;
+
+    // only events checked in UpdateAI need to be woken up, others just compare against EventClock
+    if (!IsUpdatedEvent(holder.Event->event_type) || !holder.Enabled)
+        return;
+
+    uint16 slot = uint16(&holder - &CreatureEventAIList[0]);
+    if (time)
+        EventTimers.push(EventTimer(holder.Time, slot));
+    else
+    {
+        std::vector<uint16>::iterator itr = std::lower_bound(ReadyEvents.begin(), ReadyEvents.end(), slot);
+        if (itr == ReadyEvents.end() || *itr != slot)
+            ReadyEvents.insert(itr, slot);
+    }
+}
+
+// called after events got enabled or their timers were reset in bulk
+void CreatureEventAI::RebuildEventSchedule()
+{
+    EventTimers = EventTimerQueue();
+    ReadyEvents.clear();
+
+    if (bEmptyList)
+        return;
+
+    for (std::vector<uint16>::const_iterator i = EventSlots->updated.begin(); i != EventSlots->updated.end(); ++i)
+    {
+        CreatureEventAIHolder const& holder = CreatureEventAIList[*i];
+        if (!holder.Enabled)
+            continue;
+
+        if (holder.Time > EventClock)
+            EventTimers.push(EventTimer(holder.Time, *i));
+        else
+            ReadyEvents.push_back(*i);
+    }
+}
+
+bool CreatureEventAI::IsUpdatedEvent(uint32 eventType)
+{
+    switch (eventType)
+    {
+        case EVENT_T_TIMER:
+        case EVENT_T_TIMER_OOC:
+        case EVENT_T_HP:
+        case EVENT_T_MANA:
+        case EVENT_T_RANGE:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_FRIENDLY_HP:
+            return true;
+        default:
+            return false;
+    }
+}
+
 int CreatureEventAI::Permissible(const Creature *creature)
 {
     if (creature->GetAIName() == "EventAI" )
@@ -56,33 +117,20 @@ int CreatureEventAI::Permissible(const Creature *creature)
     return PERMIT_BASE_NO;
 }
 
-CreatureEventAI::CreatureEventAI(Creature *c ) : CreatureAI(c)
+CreatureEventAI::CreatureEventAI(Creature *c ) : CreatureAI(c), EventSlots(NULL), EventClock(0)
 {
-    // Need make copy for filter unneeded steps and safe in case table reload
-    CreatureEventAI_Event_Map::const_iterator CreatureEvents = CreatureEAI_Mgr.GetCreatureEventAIMap().find(m_creature->GetEntry());
-    if (CreatureEvents != CreatureEAI_Mgr.GetCreatureEventAIMap().end())
+    // Hold a reference to the compiled table, it stays valid in case of table reload
+    EventTable = CreatureEAI_Mgr.GetCreatureEventAITable(m_creature->GetEntry());
+    if (EventTable.get())
     {
-        std::vector<CreatureEventAI_Event>::const_iterator i;
-        for (i = (*CreatureEvents).second.begin(); i != (*CreatureEvents).second.end(); ++i)
-        {
+        Map* map = m_creature->GetMap();
+        CreatureEventAI_Mode mode = !map->IsDungeon() ? EVENTAI_MODE_WORLD : (map->IsHeroic() ? EVENTAI_MODE_HEROIC : EVENTAI_MODE_NORMAL);
+        EventSlots = &EventTable->mode[mode];
+
+        CreatureEventAIList.reserve(EventSlots->events.size());
+        for (std::vector<uint16>::const_iterator i = EventSlots->events.begin(); i != EventSlots->events.end(); ++i)
+            CreatureEventAIList.push_back(CreatureEventAIHolder(&EventTable->events[*i]));
 
-            //Debug check
-            #ifndef NEO_DEBUG
-            if ((*i).event_flags & EFLAG_DEBUG_ONLY)
-                continue;
-            #endif
-            if (((*i).event_flags & (EFLAG_HEROIC | EFLAG_NORMAL)) && m_creature->GetMap()->IsDungeon() )
-            {
-                if ((m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_HEROIC) ||
-                    (!m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_NORMAL))
-                {
-                    //event flagged for instance mode
-                    CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-                }
-                continue;
-            }
-            CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-        }
         //EventMap had events but they were not added because they must be for instance
         if (CreatureEventAIList.empty())
             sLog.outError("CreatureEventAI: Creature %u has events but no events added to list because of instance flags.", m_creature->GetEntry());
@@ -99,25 +147,30 @@ CreatureEventAI::CreatureEventAI(Creature *c ) : CreatureAI(c)
 
     InvinceabilityHpLevel = 0;
 
+    EventUpdateTime = EVENT_UPDATE_TIME;
+    EventDiff = 0;
+    RebuildEventSchedule();
+
     //Handle Spawned Events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-            if (SpawnedEventConditionsCheck((*i).Event))
-                ProcessEvent(*i);
+        std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_SPAWNED];
+        for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+            if (SpawnedEventConditionsCheck(*CreatureEventAIList[*i].Event))
+                ProcessEvent(CreatureEventAIList[*i]);
     }
 }
 
 bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pActionInvoker)
 {
-    if (!pHolder.Enabled || pHolder.Time)
+    if (!pHolder.Enabled || pHolder.Time > EventClock)
         return false;
 
     //Check the inverse phase mask (event doesn't trigger if current phase bit is set in mask)
-    if (pHolder.Event.event_inverse_phase_mask & (1 << Phase))
+    if (pHolder.Event->event_inverse_phase_mask & (1 << Phase))
         return false;
 
-    CreatureEventAI_Event const& event = pHolder.Event;
+    CreatureEventAI_Event const& event = *pHolder.Event;
 
     //Check event conditions based on the event type, also reset events
     switch (event.event_type)
@@ -127,14 +180,14 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.timer.repeatMin,event.timer.repeatMax);
+            UpdateRepeatTimer(pHolder,event.timer.repeatMin,event.timer.repeatMax);
             break;
         case EVENT_T_TIMER_OOC:
             if (m_creature->isInCombat())
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.timer.repeatMin,event.timer.repeatMax);
+            UpdateRepeatTimer(pHolder,event.timer.repeatMin,event.timer.repeatMax);
             break;
         case EVENT_T_HP:
         {
@@ -147,7 +200,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder,event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_MANA:
@@ -161,14 +214,14 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder,event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_AGGRO:
             break;
         case EVENT_T_KILL:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.kill.repeatMin,event.kill.repeatMax);
+            UpdateRepeatTimer(pHolder,event.kill.repeatMin,event.kill.repeatMax);
             break;
         case EVENT_T_DEATH:
         case EVENT_T_EVADE:
@@ -177,15 +230,15 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             //Spell hit is special case, param1 and param2 handled within CreatureEventAI::SpellHit
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.spell_hit.repeatMin,event.spell_hit.repeatMax);
+            UpdateRepeatTimer(pHolder,event.spell_hit.repeatMin,event.spell_hit.repeatMax);
             break;
         case EVENT_T_RANGE:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.range.repeatMin,event.range.repeatMax);
+            UpdateRepeatTimer(pHolder,event.range.repeatMin,event.range.repeatMax);
             break;
         case EVENT_T_OOC_LOS:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.ooc_los.repeatMin,event.ooc_los.repeatMax);
+            UpdateRepeatTimer(pHolder,event.ooc_los.repeatMin,event.ooc_los.repeatMax);
             break;
         case EVENT_T_SPAWNED:
             break;
@@ -200,7 +253,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder,event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_TARGET_CASTING:
@@ -208,7 +261,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.target_casting.repeatMin,event.target_casting.repeatMax);
+            UpdateRepeatTimer(pHolder,event.target_casting.repeatMin,event.target_casting.repeatMax);
             break;
         case EVENT_T_FRIENDLY_HP:
         {
@@ -222,7 +275,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = pUnit;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_hp.repeatMin,event.friendly_hp.repeatMax);
+            UpdateRepeatTimer(pHolder,event.friendly_hp.repeatMin,event.friendly_hp.repeatMax);
             break;
         }
         case EVENT_T_FRIENDLY_IS_CC:
@@ -241,7 +294,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = *(pList.begin());
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_is_cc.repeatMin,event.friendly_is_cc.repeatMax);
+            UpdateRepeatTimer(pHolder,event.friendly_is_cc.repeatMin,event.friendly_is_cc.repeatMax);
             break;
         }
         case EVENT_T_FRIENDLY_MISSING_BUFF:
@@ -257,7 +310,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = *(pList.begin());
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_buff.repeatMin,event.friendly_buff.repeatMax);
+            UpdateRepeatTimer(pHolder,event.friendly_buff.repeatMin,event.friendly_buff.repeatMax);
             break;
         }
         case EVENT_T_SUMMONED_UNIT:
@@ -271,7 +324,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.summon_unit.repeatMin,event.summon_unit.repeatMax);
+            UpdateRepeatTimer(pHolder,event.summon_unit.repeatMin,event.summon_unit.repeatMax);
             break;
         }
         case EVENT_T_TARGET_MANA:
@@ -285,7 +338,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder,event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_REACHED_HOME:
@@ -300,7 +353,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.buffed.repeatMin,event.buffed.repeatMax);
+            UpdateRepeatTimer(pHolder,event.buffed.repeatMin,event.buffed.repeatMax);
             break;
         }
         case EVENT_T_TARGET_BUFFED:
@@ -316,28 +369,28 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.buffed.repeatMin,event.buffed.repeatMax);
+            UpdateRepeatTimer(pHolder,event.buffed.repeatMin,event.buffed.repeatMax);
             break;
         }
         default:
-            sLog.outErrorDb("CreatureEventAI: Creature %u using Event %u has invalid Event Type(%u), missing from ProcessEvent() Switch.", m_creature->GetEntry(), pHolder.Event.event_id, pHolder.Event.event_type);
+            sLog.outErrorDb("CreatureEventAI: Creature %u using Event %u has invalid Event Type(%u), missing from ProcessEvent() Switch.", m_creature->GetEntry(), pHolder.Event->event_id, pHolder.Event->event_type);
             break;
     }
 
     //Disable non-repeatable events
-    if (!(pHolder.Event.event_flags & EFLAG_REPEATABLE))
+    if (!(pHolder.Event->event_flags & EFLAG_REPEATABLE))
         pHolder.Enabled = false;
 
     //Store random here so that all random actions match up
     uint32 rnd = rand();
 
     //Return if chance for event is not met
-    if (pHolder.Event.event_chance <= rnd % 100)
+    if (pHolder.Event->event_chance <= rnd % 100)
         return false;
 
     //Process actions
     for (uint32 j = 0; j < MAX_ACTIONS; j++)
-        ProcessAction(pHolder.Event.action[j], rnd, pHolder.Event.event_id, pActionInvoker);
+        ProcessAction(pHolder.Event->action[j], rnd, pHolder.Event->event_id, pActionInvoker);
 
     return true;
 }
@@ -807,9 +860,10 @@ void CreatureEventAI::JustRespawned()
         return;
 
     //Handle Spawned Events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if (SpawnedEventConditionsCheck((*i).Event))
-            ProcessEvent(*i);
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_SPAWNED];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+        if (SpawnedEventConditionsCheck(*CreatureEventAIList[*i].Event))
+            ProcessEvent(CreatureEventAIList[*i]);
 }
 
 void CreatureEventAI::Reset()
@@ -820,26 +874,17 @@ void CreatureEventAI::Reset()
     if (bEmptyList)
         return;
 
-    //Reset all events to enabled
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    //Reset all out of combat timers
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_TIMER_OOC];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
     {
-        CreatureEventAI_Event const& event = (*i).Event;
-        switch (event.event_type)
-        {
-            //Reset all out of combat timers
-            case EVENT_T_TIMER_OOC:
-            {
-                if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
-                    (*i).Enabled = true;
-                break;
-            }
-            //default:
-            //TODO: enable below code line / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void EnterCombat()
-            //(*i).Enabled = true;
-            //(*i).Time = 0;
-            //break;
-        }
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+        if (UpdateRepeatTimer(holder, holder.Event->timer.initialMin, holder.Event->timer.initialMax))
+            holder.Enabled = true;
     }
+    //TODO: enable all other events here / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void EnterCombat()
+
+    RebuildEventSchedule();
 }
 
 void CreatureEventAI::JustReachedHome()
@@ -848,11 +893,9 @@ void CreatureEventAI::JustReachedHome()
 
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        {
-            if ((*i).Event.event_type == EVENT_T_REACHED_HOME)
-                ProcessEvent(*i);
-        }
+        std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_REACHED_HOME];
+        for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+            ProcessEvent(CreatureEventAIList[*i]);
     }
 
     Reset();
@@ -866,11 +909,9 @@ void CreatureEventAI::EnterEvadeMode()
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_EVADE)
-            ProcessEvent(*i);
-    }
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_EVADE];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i]);
 }
 
 void CreatureEventAI::JustDied(Unit* killer)
@@ -881,11 +922,9 @@ void CreatureEventAI::JustDied(Unit* killer)
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_DEATH)
-            ProcessEvent(*i, killer);
-    }
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_DEATH];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], killer);
 
     // reset phase after any death state events
     Phase = 0;
@@ -896,11 +935,9 @@ void CreatureEventAI::KilledUnit(Unit* victim)
     if (bEmptyList || victim->GetTypeId() != TYPEID_PLAYER)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_KILL)
-            ProcessEvent(*i, victim);
-    }
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_KILL];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* pUnit)
@@ -908,11 +945,9 @@ void CreatureEventAI::JustSummoned(Creature* pUnit)
     if (bEmptyList || !pUnit)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_SUMMONED_UNIT)
-            ProcessEvent(*i, pUnit);
-    }
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_SUMMONED_UNIT];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], pUnit);
 }
 
 void CreatureEventAI::EnterCombat(Unit *enemy)
@@ -920,9 +955,9 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
     //Check for on combat start events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+        for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
         {
-            CreatureEventAI_Event const& event = (*i).Event;
+            CreatureEventAI_Event const& event = *(*i).Event;
             switch (event.event_type)
             {
                 case EVENT_T_AGGRO:
@@ -931,13 +966,13 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
                     break;
                     //Reset all in combat timers
                 case EVENT_T_TIMER:
-                    if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
+                    if (UpdateRepeatTimer(*i,event.timer.initialMin,event.timer.initialMax))
                         (*i).Enabled = true;
                     break;
                     //All normal events need to be re-enabled and their time set to 0
                 default:
                     (*i).Enabled = true;
-                    (*i).Time = 0;
+                    (*i).Time = EventClock;
                     break;
             }
         }
@@ -945,6 +980,7 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
 
     EventUpdateTime = EVENT_UPDATE_TIME;
     EventDiff = 0;
+    RebuildEventSchedule();
 }
 
 void CreatureEventAI::AttackStart(Unit *who)
@@ -973,21 +1009,21 @@ void CreatureEventAI::MoveInLineOfSight(Unit *who)
     //Check for OOC LOS Event
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+        std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_OOC_LOS];
+        for (std::vector<uint16>::const_iterator itr = slots.begin(); itr != slots.end(); ++itr)
         {
-            if ((*itr).Event.event_type == EVENT_T_OOC_LOS)
-            {
-                //can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (*itr).Event.ooc_los.maxRange;
+            CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
 
-                //if range is ok and we are actually in LOS
-                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                {
-                    //if friendly event&&who is not hostile OR hostile event&&who is hostile
-                    if (((*itr).Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                        ((!(*itr).Event.ooc_los.noHostile) && m_creature->IsHostileTo(who)))
-                        ProcessEvent(*itr, who);
-                }
+            //can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = holder.Event->ooc_los.maxRange;
+
+            //if range is ok and we are actually in LOS
+            if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+            {
+                //if friendly event&&who is not hostile OR hostile event&&who is hostile
+                if ((holder.Event->ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                    ((!holder.Event->ooc_los.noHostile) && m_creature->IsHostileTo(who)))
+                    ProcessEvent(holder, who);
             }
         }
     }
@@ -1001,12 +1037,15 @@ void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if ((*i).Event.event_type == EVENT_T_SPELLHIT)
-            //If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!(*i).Event.spell_hit.spellId || pSpell->Id == (*i).Event.spell_hit.spellId)
-                if (pSpell->SchoolMask & (*i).Event.spell_hit.schoolMask)
-                    ProcessEvent(*i, pUnit);
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_SPELLHIT];
+    for (std::vector<uint16>::const_iterator i = slots.begin(); i != slots.end(); ++i)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+        //If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event->spell_hit.spellId || pSpell->Id == holder.Event->spell_hit.spellId)
+            if (pSpell->SchoolMask & holder.Event->spell_hit.schoolMask)
+                ProcessEvent(holder, pUnit);
+    }
 }
 
 void CreatureEventAI::UpdateAI(const uint32 diff)
@@ -1021,29 +1060,40 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
         {
             EventDiff += diff;
 
-            //Check for time based events
-            for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+            uint64 lastClock = EventClock;
+            EventClock += EventDiff;
+
+            //Do not decrement timers if event cannot trigger in this phase
+            for (std::vector<uint16>::const_iterator i = EventSlots->phaseMasked.begin(); i != EventSlots->phaseMasked.end(); ++i)
             {
-                //Decrement Timers
-                if ((*i).Time)
-                {
-                    if ((*i).Time > EventDiff)
-                    {
-                        //Do not decrement timers if event cannot trigger in this phase
-                        if (!((*i).Event.event_inverse_phase_mask & (1 << Phase)))
-                            (*i).Time -= EventDiff;
+                CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+                if (holder.Time > EventClock && (holder.Event->event_inverse_phase_mask & (1 << Phase)))
+                    SetEventTimer(holder, uint32(holder.Time - lastClock));
+            }
 
-                        //Skip processing of events that have time remaining
-                        continue;
-                    }
-                    else (*i).Time = 0;
-                }
+            //Wake up events whose timers expired, entries of rescheduled timers are stale
+            while (!EventTimers.empty() && EventTimers.top().first <= EventClock)
+            {
+                EventTimer timer = EventTimers.top();
+                EventTimers.pop();
+
+                CreatureEventAIHolder& holder = CreatureEventAIList[timer.second];
+                if (holder.Time == timer.first)
+                    SetEventTimer(holder, 0);
+            }
 
-                //Events that are updated every EVENT_UPDATE_TIME
-                switch ((*i).Event.event_type)
+            //Events that are updated every EVENT_UPDATE_TIME, actions may change the ready list so walk a copy
+            ReadyEventsScratch = ReadyEvents;
+            for (std::vector<uint16>::const_iterator i = ReadyEventsScratch.begin(); i != ReadyEventsScratch.end(); ++i)
+            {
+                CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+                if (holder.Time > EventClock)
+                    continue;
+
+                switch (holder.Event->event_type)
                 {
                     case EVENT_T_TIMER_OOC:
-                        ProcessEvent(*i);
+                        ProcessEvent(holder);
                         break;
                     case EVENT_T_TIMER:
                     case EVENT_T_MANA:
@@ -1052,17 +1102,27 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
                     case EVENT_T_TARGET_CASTING:
                     case EVENT_T_FRIENDLY_HP:
                         if (me->getVictim())
-                            ProcessEvent(*i);
+                            ProcessEvent(holder);
                         break;
                     case EVENT_T_RANGE:
                         if (me->getVictim())
                             if (m_creature->IsInMap(m_creature->getVictim()))
-                                if (m_creature->IsInRange(m_creature->getVictim(),(float)(*i).Event.range.minDist,(float)(*i).Event.range.maxDist))
-                                    ProcessEvent(*i);
+                                if (m_creature->IsInRange(m_creature->getVictim(),(float)holder.Event->range.minDist,(float)holder.Event->range.maxDist))
+                                    ProcessEvent(holder);
                         break;
                 }
             }
 
+            //Events that got a timer or were disabled leave the ready list
+            std::vector<uint16>::iterator last = ReadyEvents.begin();
+            for (std::vector<uint16>::const_iterator i = ReadyEvents.begin(); i != ReadyEvents.end(); ++i)
+            {
+                CreatureEventAIHolder const& holder = CreatureEventAIList[*i];
+                if (holder.Enabled && holder.Time <= EventClock)
+                    *last++ = *i;
+            }
+            ReadyEvents.erase(last, ReadyEvents.end());
+
             EventDiff = 0;
             EventUpdateTime = EVENT_UPDATE_TIME;
         }
@@ -1320,19 +1380,18 @@ void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+    std::vector<uint16> const& slots = EventSlots->byType[EVENT_T_RECEIVE_EMOTE];
+    for (std::vector<uint16>::const_iterator itr = slots.begin(); itr != slots.end(); ++itr)
     {
-        if ((*itr).Event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if ((*itr).Event.receive_emote.emoteId != text_emote)
-                return;
+        CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
+        if (holder.Event->receive_emote.emoteId != text_emote)
+            return;
 
-            PlayerCondition pcon((*itr).Event.receive_emote.condition,(*itr).Event.receive_emote.conditionValue1,(*itr).Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer))
-            {
-                sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        PlayerCondition pcon(holder.Event->receive_emote.condition,holder.Event->receive_emote.conditionValue1,holder.Event->receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer))
+        {
+            sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
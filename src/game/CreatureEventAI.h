@@ -26,6 +26,10 @@
 #include "CreatureAI.h"
 #include "Unit.h"
 
+#include <ace/Refcounted_Auto_Ptr.h>
+#include <ace/Thread_Mutex.h>
+#include <queue>
+
 class Player;
 class WorldObject;
 
@@ -557,16 +561,41 @@ struct CreatureEventAI_Summon
 //EventSummon_Map
 typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map;
 
+// which events of an entry a creature gets, depends on its map
+enum CreatureEventAI_Mode
+{
+    EVENTAI_MODE_WORLD          = 0,                        // not a dungeon, instance flagged events are used too
+    EVENTAI_MODE_NORMAL         = 1,
+    EVENTAI_MODE_HEROIC         = 2,
+    MAX_EVENTAI_MODE
+};
+
+// Events of one creature entry, compiled at load and shared by all creatures of the entry.
+// A creature's events are numbered by slot, slots keep the table order of the events.
+struct CreatureEventAI_EventTable
+{
+    struct Slots
+    {
+        std::vector<uint16> events;                         // slot -> index in events
+        std::vector<uint16> byType[EVENT_T_END];            // slots per event type
+        std::vector<uint16> updated;                        // slots of events checked in UpdateAI
+        std::vector<uint16> phaseMasked;                    // slots with inverse phase mask, their timers pause
+    };
+
+    CreatureEventAI_Event_Vec events;
+    Slots mode[MAX_EVENTAI_MODE];
+};
+typedef ACE_Refcounted_Auto_Ptr<CreatureEventAI_EventTable, ACE_Thread_Mutex> CreatureEventAI_EventTablePtr;
+typedef UNORDERED_MAP<uint32, CreatureEventAI_EventTablePtr> CreatureEventAI_EventTable_Map;
+
+// per creature state of one event
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true){}
+    explicit CreatureEventAIHolder(CreatureEventAI_Event const* p) : Event(p), Time(0), Enabled(true){}
 
-    CreatureEventAI_Event Event;
-    uint32 Time;
+    CreatureEventAI_Event const* Event;
+    uint64 Time;                                            // EventClock value the event is due at
     bool Enabled;
-
-    // helper
-    bool UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax);
 };
 
 class NEO_DLL_SPEC CreatureEventAI : public CreatureAI
@@ -574,10 +603,7 @@ class NEO_DLL_SPEC CreatureEventAI : public CreatureAI
 
     public:
         explicit CreatureEventAI(Creature *c);
-        ~CreatureEventAI()
-        {
-            CreatureEventAIList.clear();
-        }
+        ~CreatureEventAI() {}
         void JustRespawned();
         void Reset();
         void JustReachedHome();
@@ -605,17 +631,31 @@ class NEO_DLL_SPEC CreatureEventAI : public CreatureAI
         bool CanCast(Unit* Target, SpellEntry const *Spell, bool Triggered);
 
         bool SpawnedEventConditionsCheck(CreatureEventAI_Event const& event);
+        static bool IsUpdatedEvent(uint32 eventType);
+
+        bool UpdateRepeatTimer(CreatureEventAIHolder& holder, uint32 repeatMin, uint32 repeatMax);
+        void SetEventTimer(CreatureEventAIHolder& holder, uint32 time);
+        void RebuildEventSchedule();
 
         Unit* DoSelectLowestHpFriendly(float range, uint32 MinHPDiff);
         void DoFindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
         void DoFindFriendlyCC(std::list<Creature*>& _list, float range);
 
-                                                            //Holder for events (stores enabled, time, and eventid)
-        std::list<CreatureEventAIHolder> CreatureEventAIList;
+                                                            //Holder for events (stores enabled, time, and eventid), indexed by slot
+        std::vector<CreatureEventAIHolder> CreatureEventAIList;
+        CreatureEventAI_EventTablePtr EventTable;           // keeps the shared events alive over a table reload
+        CreatureEventAI_EventTable::Slots const* EventSlots;
         uint32 EventUpdateTime;                             //Time between event updates
         uint32 EventDiff;                                   //Time between the last event call
         bool bEmptyList;
 
+        typedef std::pair<uint64, uint16> EventTimer;       // due time, slot
+        typedef std::priority_queue<EventTimer, std::vector<EventTimer>, std::greater<EventTimer> > EventTimerQueue;
+        uint64 EventClock;                                  // sum of all EventDiff, event timers run against it
+        EventTimerQueue EventTimers;                        // pending timers of updated events, stale entries skipped
+        std::vector<uint16> ReadyEvents;                    // updated events that are due, in slot order
+        std::vector<uint16> ReadyEventsScratch;
+
         //Variables used by Events themselves
         uint8 Phase;                                        // Current phase, max 32 phases
         bool CombatMovementEnabled;                         // If we allow targeted movment gen (movement twoards top threat)
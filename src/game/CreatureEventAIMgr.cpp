@@ -237,8 +237,9 @@ void CreatureEventAIMgr::CheckUnusedAISummons()
 // -------------------
 void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
 {
-    //Drop Existing EventAI List
+    //Drop Existing EventAI List, creatures keep their own reference to the old tables
     m_CreatureEventAI_Event_Map.clear();
+    m_CreatureEventAI_EventTable_Map.clear();
 
     // Gather event data
     QueryResult_AutoPtr result = WorldDatabase.Query("SELECT id, creature_id, event_type, event_inverse_phase_mask, event_chance, event_flags, "
@@ -799,6 +800,7 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
 
         CheckUnusedAITexts();
         CheckUnusedAISummons();
+        BuildEventTables();
 
         sLog.outString("");
         sLog.outString(">> Loaded %u CreatureEventAI scripts", Count);
@@ -811,3 +813,42 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
         sLog.outString(">> Loaded 0 CreatureEventAI scripts. DB table creature_ai_scripts is empty.");
     }
 }
+
+void CreatureEventAIMgr::BuildEventTables()
+{
+    for (CreatureEventAI_Event_Map::const_iterator itr = m_CreatureEventAI_Event_Map.begin(); itr != m_CreatureEventAI_Event_Map.end(); ++itr)
+    {
+        CreatureEventAI_EventTable* table = new CreatureEventAI_EventTable;
+
+        for (CreatureEventAI_Event_Vec::const_iterator i = itr->second.begin(); i != itr->second.end(); ++i)
+        {
+            #ifndef NEO_DEBUG
+            if (i->event_flags & EFLAG_DEBUG_ONLY)
+                continue;
+            #endif
+
+            uint16 index = table->events.size();
+            table->events.push_back(*i);
+
+            for (uint8 mode = 0; mode < MAX_EVENTAI_MODE; ++mode)
+            {
+                // events flagged for an instance mode only happen in dungeons of that mode
+                if (mode != EVENTAI_MODE_WORLD && (i->event_flags & (EFLAG_HEROIC | EFLAG_NORMAL)) &&
+                    !(i->event_flags & (mode == EVENTAI_MODE_HEROIC ? EFLAG_HEROIC : EFLAG_NORMAL)))
+                    continue;
+
+                CreatureEventAI_EventTable::Slots& slots = table->mode[mode];
+                uint16 slot = slots.events.size();
+                slots.events.push_back(index);
+                if (i->event_type < EVENT_T_END)
+                    slots.byType[i->event_type].push_back(slot);
+                if (CreatureEventAI::IsUpdatedEvent(i->event_type))
+                    slots.updated.push_back(slot);
+                if (i->event_inverse_phase_mask)
+                    slots.phaseMasked.push_back(slot);
+            }
+        }
+
+        m_CreatureEventAI_EventTable_Map[itr->first] = CreatureEventAI_EventTablePtr(table);
+    }
+}
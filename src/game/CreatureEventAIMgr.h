@@ -35,14 +35,21 @@ class CreatureEventAIMgr
         void LoadCreatureEventAI_Scripts();
 
         CreatureEventAI_Event_Map  const& GetCreatureEventAIMap()       const { return m_CreatureEventAI_Event_Map; }
+        CreatureEventAI_EventTablePtr GetCreatureEventAITable(uint32 entry) const
+        {
+            CreatureEventAI_EventTable_Map::const_iterator itr = m_CreatureEventAI_EventTable_Map.find(entry);
+            return itr != m_CreatureEventAI_EventTable_Map.end() ? itr->second : CreatureEventAI_EventTablePtr();
+        }
         CreatureEventAI_Summon_Map const& GetCreatureEventAISummonMap() const { return m_CreatureEventAI_Summon_Map; }
         CreatureEventAI_TextMap    const& GetCreatureEventAITextMap()   const { return m_CreatureEventAI_TextMap; }
 
     private:
         void CheckUnusedAITexts();
         void CheckUnusedAISummons();
+        void BuildEventTables();
 
         CreatureEventAI_Event_Map  m_CreatureEventAI_Event_Map;
+        CreatureEventAI_EventTable_Map m_CreatureEventAI_EventTable_Map;
         CreatureEventAI_Summon_Map m_CreatureEventAI_Summon_Map;
         CreatureEventAI_TextMap    m_CreatureEventAI_TextMap;
 };
@@ -35,6 +35,11 @@
 #include "BattleGroundMgr.h"
 #include <fstream>
 #include "ObjectMgr.h"
+#include "DynamicObject.h"
+#include "GameObject.h"
+#include "Spell.h"
+#include "LootMgr.h"
+#include "SpellAuras.h"
 
 bool ChatHandler::HandleDebugInArcCommand(const char* /*args*/)
 {
@@ -576,6 +581,80 @@ bool ChatHandler::HandleDebugThreatList(const char * /*args*/)
     return true;
 }
 
+template<class T>
+static void ShowObjectPoolStats(ChatHandler* handler, const char* name)
+{
+    ObjectPoolStats stats = ObjectPool<T>::GetStats();
+    handler->PSendSysMessage("   %s: in use %ld, cached %ld, heap allocations %ld, reused %ld",
+        name, stats.inUse, stats.cached, stats.allocated, stats.reused);
+}
+
+bool ChatHandler::HandleDebugPoolsCommand(const char * /*args*/)
+{
+    SendSysMessage("Object pools:");
+    ShowObjectPoolStats<Creature>(this, "Creature");
+    ShowObjectPoolStats<GameObject>(this, "GameObject");
+    ShowObjectPoolStats<DynamicObject>(this, "DynamicObject");
+    ShowObjectPoolStats<Spell>(this, "Spell");
+    ShowObjectPoolStats<Aura>(this, "Aura");
+    return true;
+}
+
+// .debug lootgroup $table $entry $group [$rolls]
+// rolls a loot group with its alias table and with the old sequential roll, both should give the same distribution
+bool ChatHandler::HandleDebugLootGroupCommand(const char * args)
+{
+    char* tableStr = strtok((char*)args, " ");
+    char* entryStr = strtok(NULL, " ");
+    char* groupStr = strtok(NULL, " ");
+    char* rollsStr = strtok(NULL, " ");
+    if (!tableStr || !entryStr || !groupStr)
+        return false;
+
+    static LootStore const* stores[] =
+    {
+        &LootTemplates_Creature, &LootTemplates_Fishing, &LootTemplates_Gameobject, &LootTemplates_Item, &LootTemplates_Mail,
+        &LootTemplates_Pickpocketing, &LootTemplates_Skinning, &LootTemplates_Disenchant, &LootTemplates_Prospecting, &LootTemplates_Reference
+    };
+
+    // "creature" is enough for creature_loot_template
+    LootStore const* store = NULL;
+    for (uint32 i = 0; i < sizeof(stores) / sizeof(stores[0]); ++i)
+        if (strncmp(stores[i]->GetName(), tableStr, strlen(tableStr)) == 0)
+        {
+            store = stores[i];
+            break;
+        }
+
+    uint32 entry = atoi(entryStr);
+    uint32 group = atoi(groupStr);
+    uint32 rolls = rollsStr ? atoi(rollsStr) : 1000000;
+    if (!store || !rolls || rolls > 100000000 || group > 255)
+        return false;
+
+    LootTemplate const* tab = store->GetLootFor(entry);
+    LootRollCounts counts;
+    if (!tab || !tab->CompareGroupRolls(group, rolls, counts))
+    {
+        PSendSysMessage("%s has no group %u for entry %u", store->GetName(), group, entry);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    // two sample chi square, sequential and alias counts should come from the same distribution
+    double chiSquare = 0.0;
+    PSendSysMessage("%s entry %u group %u, %u rolls each:", store->GetName(), entry, group, rolls);
+    for (LootRollCounts::const_iterator itr = counts.begin(); itr != counts.end(); ++itr)
+    {
+        double seq = itr->second.first;
+        double alias = itr->second.second;
+        chiSquare += (seq - alias) * (seq - alias) / (seq + alias);
+        PSendSysMessage("   item %u: sequential %.3f%%, alias %.3f%%", itr->first, seq * 100.0 / rolls, alias * 100.0 / rolls);
+    }
+    PSendSysMessage("chi square %.2f with %u degrees of freedom", chiSquare, uint32(counts.size() - 1));
+    return true;
+}
+
 bool ChatHandler::HandleDebugHostilRefList(const char * /*args*/)
 {
     Unit* target = getSelectedUnit();
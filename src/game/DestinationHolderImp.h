@@ -138,7 +138,10 @@ DestinationHolder<TRAVELLER>::UpdateTraveller(TRAVELLER &traveller, uint32 diff,
     if (traveller.GetTraveller().GetPositionX() != x || traveller.GetTraveller().GetPositionY() != y )
     {
         float ori = traveller.GetTraveller().GetAngle(x, y);
-        traveller.Relocation(x, y, z, ori);
+        if (HasArrived())
+            traveller.Relocation(x, y, z, ori);
+        else
+            traveller.PathStep(x, y, z, ori);
     }
 
     return true;
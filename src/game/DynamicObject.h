@@ -22,6 +22,7 @@
 #define NEOCORE_DYNAMICOBJECT_H
 
 #include "Object.h"
+#include "Utilities/ObjectPool.h"
 
 class Unit;
 struct SpellEntry;
@@ -29,6 +30,8 @@ struct SpellEntry;
 class DynamicObject : public WorldObject
 {
     public:
+        DECLARE_OBJECT_POOL(DynamicObject)
+
         typedef std::set<Unit*> AffectedSet;
         explicit DynamicObject();
 
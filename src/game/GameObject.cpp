@@ -85,6 +85,7 @@ void GameObject::AddToWorld()
     if (!IsInWorld())
     {
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->InsertObjectGuid(this);
         WorldObject::AddToWorld();
     }
 }
@@ -95,8 +96,11 @@ void GameObject::RemoveFromWorld()
     if (IsInWorld())
     {
         if (Map *map = FindMap())
+        {
             if (map->IsDungeon() && ((InstanceMap*)map)->GetInstanceData())
                 ((InstanceMap*)map)->GetInstanceData()->OnObjectRemove(this);
+            map->RemoveObjectGuid(this);
+        }
         ObjectAccessor::Instance().RemoveObject(this);
         WorldObject::RemoveFromWorld();
     }
@@ -26,6 +26,7 @@
 #include "Object.h"
 #include "LootMgr.h"
 #include "Database/DatabaseEnv.h"
+#include "Utilities/ObjectPool.h"
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined(__GNUC__ )
@@ -423,6 +424,8 @@ class Unit;
 class NEO_DLL_SPEC GameObject : public WorldObject
 {
     public:
+        DECLARE_OBJECT_POOL(GameObject)
+
         explicit GameObject();
         ~GameObject();
 
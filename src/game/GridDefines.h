@@ -56,6 +56,7 @@ class Player;
 #define CENTER_GRID_CELL_OFFSET (SIZE_OF_GRID_CELL/2)
 
 #define TOTAL_NUMBER_OF_CELLS_PER_MAP    (MAX_NUMBER_OF_GRIDS*MAX_NUMBER_OF_CELLS)
+#define NO_INTEREST_CELL                 0xFFFFFFFF
 
 #define MAP_RESOLUTION 128
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * Copyright (C) 2008 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "GridMapLoader.h"
+#include "Map.h"
+#include "World.h"
+#include "Log.h"
+#include "ace/Method_Request.h"
+
+class GridMapLoader::LoadRequest : public ACE_Method_Request
+{
+    public:
+        LoadRequest(GridMapLoader& loader, uint32 key) : m_loader(loader), m_key(key) {}
+
+        int call()
+        {
+            m_loader.Load(m_key);
+            return 0;
+        }
+
+    private:
+        GridMapLoader& m_loader;
+        uint32 m_key;
+};
+
+GridMapLoader::GridMapLoader() : m_running(true)
+{
+}
+
+GridMapLoader::~GridMapLoader()
+{
+    for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+        delete itr->second.gridMap;
+}
+
+void GridMapLoader::Request(uint32 mapid, uint32 gx, uint32 gy)
+{
+    uint32 key = MakeKey(mapid, gx, gy);
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        if (!m_running || m_entries.find(key) != m_entries.end())
+            return;
+        m_entries[key] = Entry();
+    }
+
+    if (m_queue.enqueue(new LoadRequest(*this, key)) == -1)
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_entries.erase(key);
+    }
+}
+
+bool GridMapLoader::IsReading(uint32 mapid, uint32 gx, uint32 gy) const
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    EntryMap::const_iterator itr = m_entries.find(MakeKey(mapid, gx, gy));
+    return itr != m_entries.end() && !itr->second.done;
+}
+
+GridMap* GridMapLoader::Take(uint32 mapid, uint32 gx, uint32 gy)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    EntryMap::iterator itr = m_entries.find(MakeKey(mapid, gx, gy));
+    if (itr == m_entries.end())
+        return NULL;
+
+    // the caller reads the file itself now, Load() throws its copy away
+    if (!itr->second.done)
+    {
+        itr->second.dropped = true;
+        return NULL;
+    }
+
+    GridMap* gridMap = itr->second.gridMap;
+    m_entries.erase(itr);
+    return gridMap;
+}
+
+void GridMapLoader::Load(uint32 key)
+{
+    uint32 mapid = key >> 16;
+    uint32 gx = (key >> 8) & 0xFF;
+    uint32 gy = key & 0xFF;
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        EntryMap::iterator itr = m_entries.find(key);
+        if (itr == m_entries.end() || itr->second.dropped)
+        {
+            m_entries.erase(key);
+            return;
+        }
+    }
+
+    // same file name and error handling as Map::LoadMap
+    std::string filename = sWorld.GetDataPath() + "maps/";
+    char name[16];
+    snprintf(name, sizeof(name), "%03u%02u%02u.map", mapid, gx, gy);
+    filename += name;
+
+    DEBUG_LOG("Reading map %s ahead", filename.c_str());
+    GridMap* gridMap = new GridMap();
+    if (!gridMap->loadData((char*)filename.c_str()))
+        sLog.outError("Error load map file: \n %s\n", filename.c_str());
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    EntryMap::iterator itr = m_entries.find(key);
+    if (itr == m_entries.end() || itr->second.dropped)
+    {
+        delete gridMap;
+        m_entries.erase(key);
+        return;
+    }
+    itr->second.gridMap = gridMap;
+    itr->second.done = true;
+}
+
+void GridMapLoader::Stop()
+{
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_running = false;
+    }
+    m_queue.queue()->deactivate();
+}
+
+void GridMapLoader::run()
+{
+    while (m_running)
+    {
+        // returns NULL once Stop() deactivated the queue
+        if (ACE_Method_Request* request = m_queue.dequeue())
+        {
+            request->call();
+            delete request;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * Copyright (C) 2008 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef NEO_GRIDMAPLOADER_H
+#define NEO_GRIDMAPLOADER_H
+
+#include "Platform/Define.h"
+#include "Threading.h"
+#include "Utilities/UnorderedMap.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Activation_Queue.h"
+
+class GridMap;
+
+// Reads and parses the terrain (.map) files of base map grids in its own thread, so the grid
+// preloader does not stall the map thread on disk. Map::LoadMap takes the prepared GridMap;
+// vmaps and the grid objects are still loaded on the map thread.
+class GridMapLoader : public ACE_Based::Runnable
+{
+    public:
+        GridMapLoader();
+        ~GridMapLoader();
+
+        // queues reading the grid's terrain, nothing happens if it is already queued or read
+        void Request(uint32 mapid, uint32 gx, uint32 gy);
+        // true while the terrain is queued or being read
+        bool IsReading(uint32 mapid, uint32 gx, uint32 gy) const;
+        // the prepared terrain or NULL, a request not done yet is dropped and its result deleted
+        GridMap* Take(uint32 mapid, uint32 gx, uint32 gy);
+
+        void Stop();
+        virtual void run();
+
+    private:
+        class LoadRequest;
+
+        struct Entry
+        {
+            Entry() : gridMap(NULL), done(false), dropped(false) {}
+
+            GridMap* gridMap;
+            bool done;
+            bool dropped;
+        };
+        typedef UNORDERED_MAP<uint32, Entry> EntryMap;
+
+        static uint32 MakeKey(uint32 mapid, uint32 gx, uint32 gy) { return (mapid << 16) | (gx << 8) | gy; }
+        void Load(uint32 key);
+
+        ACE_Activation_Queue m_queue;
+        mutable ACE_Thread_Mutex m_lock;                    // guards m_entries
+        EntryMap m_entries;
+        volatile bool m_running;
+};
+#endif
@@ -19,6 +19,7 @@
  */
 
 #include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "UpdateData.h"
@@ -40,10 +41,7 @@ VisibleChangesNotifier::Visit(PlayerMapType &m)
 
         iter->getSource()->UpdateVisibilityOf(&i_object);
 
-        if (!iter->getSource()->GetSharedVisionList().empty())
-            for (SharedVisionList::const_iterator i = iter->getSource()->GetSharedVisionList().begin();
-                i != iter->getSource()->GetSharedVisionList().end(); ++i)
-                    (*i)->UpdateVisibilityOf(&i_object);
+        SharedVisionRelocationWorker(iter->getSource(), &i_object);
     }
 }
 
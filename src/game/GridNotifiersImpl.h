@@ -37,6 +37,16 @@ Neo::ObjectUpdater::Visit(CreatureMapType &m)
             iter->getSource()->Update(i_timeDiff);
 }
 
+// players seeing through pl's eyes have to see the moved object as well
+inline void SharedVisionRelocationWorker(Player* pl, WorldObject* obj)
+{
+    if (pl->GetSharedVisionList().empty())
+        return;
+
+    for (SharedVisionList::const_iterator it = pl->GetSharedVisionList().begin(); it != pl->GetSharedVisionList().end(); ++it)
+        (*it)->UpdateVisibilityOf(obj);
+}
+
 inline void PlayerCreatureRelocationWorker(Player* pl, Creature* c)
 {
     if (!pl->isAlive() || !c->isAlive() || pl->isInFlight())
@@ -84,6 +94,10 @@ Neo::PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         i_clientGUIDs.erase(iter->getSource()->GetGUID());
 
+        // done before the notified check: Map::RelocationNotify leaves these cells to this notifier
+        if (iter->getSource() != &i_player)
+            SharedVisionRelocationWorker(iter->getSource(), &i_player);
+
         if (iter->getSource()->m_Notified) //self is also skipped in this check
             continue;
 
@@ -124,6 +138,8 @@ Neo::CreatureRelocationNotifier::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
+        SharedVisionRelocationWorker(iter->getSource(), &i_creature);
+
         if (iter->getSource()->m_Notified)
             continue;
 
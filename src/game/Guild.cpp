@@ -45,6 +45,10 @@ Guild::Guild()
     CreatedYear = 0;
     CreatedMonth = 0;
     CreatedDay = 0;
+
+    m_bankloaded = false;
+    m_eventlogloaded = false;
+    m_bankEventLogLoaded = false;
 }
 
 Guild::~Guild()
@@ -227,6 +231,7 @@ bool Guild::LoadGuildFromDB(uint32 GuildId)
     sLog.outDebug("Guild %u Creation time Loaded day: %u, month: %u, year: %u", GuildId, CreatedDay, CreatedMonth, CreatedYear);
     m_bankloaded = false;
     m_eventlogloaded = false;
+    m_bankEventLogLoaded = false;
     m_onlinemembers = 0;
     RenumBankLogs();
     RenumGuildEventlog();
@@ -813,9 +818,8 @@ void Guild::UpdateLogoutTime(uint64 guid)
 // Display guild eventlog
 void Guild::DisplayGuildEventlog(WorldSession *session)
 {
-    // Load guild eventlog, if not already done
     if (!m_eventlogloaded)
-        LoadGuildEventLogFromDB();
+        return;
 
     // Sending result
     WorldPacket data(MSG_GUILD_EVENT_LOG_QUERY, 0);
@@ -840,14 +844,15 @@ void Guild::DisplayGuildEventlog(WorldSession *session)
     sLog.outDebug("WORLD: Sent (MSG_GUILD_EVENT_LOG_QUERY)");
 }
 
-// Load guild eventlog from DB
-void Guild::LoadGuildEventLogFromDB()
+// Load guild eventlog from the result of
+// SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY LogGuid DESC LIMIT GUILD_EVENTLOG_MAX_ENTRIES
+void Guild::LoadGuildEventLogFromDB(QueryResult_AutoPtr result)
 {
-    // Return if already loaded
+    // Return if already loaded, another member's query may have finished first
     if (m_eventlogloaded)
         return;
 
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY LogGuid DESC LIMIT %u", Id, GUILD_EVENTLOG_MAX_ENTRIES);
+    m_eventlogloaded = true;
     if (!result)
         return;
     do
@@ -870,8 +875,6 @@ void Guild::LoadGuildEventLogFromDB()
     // This cases can happen only if a crash occured somewhere and table has too many log entries
     if (!m_GuildEventlog.empty())
         CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE guildid=%u AND LogGuid < %u", Id, m_GuildEventlog.front().LogGuid);
-
-    m_eventlogloaded = true;
 }
 
 // Unload guild eventlog
@@ -1065,9 +1068,8 @@ Item* Guild::GetItem(uint8 TabId, uint8 SlotId)
 
 void Guild::DisplayGuildBankTabsInfo(WorldSession *session)
 {
-    // Time to load bank if not already done
     if (!m_bankloaded)
-        LoadGuildBankFromDB();
+        return;
 
     WorldPacket data(SMSG_GUILD_BANK_LIST, 500);
 
@@ -1153,17 +1155,20 @@ uint32 Guild::GetBankRights(uint32 rankId, uint8 TabId) const
 // *************************************************
 // Guild bank loading/unloading related
 
-// This load should be called when the bank is first accessed by a guild member
-void Guild::LoadGuildBankFromDB()
+// This load is done when the bank is first accessed by a guild member, from the result of a query
+// listing every tab with its items, a tab without items gets one row with NULL item fields:
+//        0        1        2          3          4          5          6             7
+// SELECT ii.data, t.TabId, t.TabName, t.TabIcon, t.TabText, gi.SlotId, gi.item_guid, gi.item_entry
+// FROM guild_bank_tab t LEFT JOIN guild_bank_item gi ON gi.guildid = t.guildid AND gi.TabId = t.TabId
+// LEFT JOIN item_instance ii ON ii.guid = gi.item_guid WHERE t.guildid='%u' ORDER BY t.TabId
+void Guild::LoadGuildBankFromDB(QueryResult_AutoPtr result)
 {
+    // another member's query may have finished first
     if (m_bankloaded)
         return;
 
     m_bankloaded = true;
-    LoadGuildBankEventLogFromDB();
 
-    //                                                     0      1        2        3
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT TabId, TabName, TabIcon, TabText FROM guild_bank_tab WHERE guildid='%u' ORDER BY TabId", Id);
     if (!result)
     {
         purchased_tabs = 0;
@@ -1171,41 +1176,36 @@ void Guild::LoadGuildBankFromDB()
     }
 
     m_TabListMap.resize(purchased_tabs);
-    do
-    {
-        Field *fields = result->Fetch();
-        uint8 TabId = fields[0].GetUInt8();
-
-        GuildBankTab *NewTab = new GuildBankTab;
-        memset(NewTab->Slots, 0, GUILD_BANK_MAX_SLOTS * sizeof(Item*));
-
-        NewTab->Name = fields[1].GetCppString();
-        NewTab->Icon = fields[2].GetCppString();
-        NewTab->Text = fields[3].GetCppString();
-
-        m_TabListMap[TabId] = NewTab;
-    }while (result->NextRow());
-
-    // data needs to be at first place for Item::LoadFromDB
-    //                                        0     1      2       3          4
-    result = CharacterDatabase.PQuery("SELECT data, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId", Id);
-    if (!result)
-        return;
-
     do
     {
         Field *fields = result->Fetch();
         uint8 TabId = fields[1].GetUInt8();
-        uint8 SlotId = fields[2].GetUInt8();
-        uint32 ItemGuid = fields[3].GetUInt32();
-        uint32 ItemEntry = fields[4].GetUInt32();
 
         if (TabId >= purchased_tabs || TabId >= GUILD_BANK_MAX_TABS)
         {
-            sLog.outError("Guild::LoadGuildBankFromDB: Invalid tab for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid,ItemEntry);
+            sLog.outError("Guild::LoadGuildBankFromDB: Invalid tab %u in guild bank, skipped.", uint32(TabId));
             continue;
         }
 
+        if (!m_TabListMap[TabId])
+        {
+            GuildBankTab *NewTab = new GuildBankTab;
+            memset(NewTab->Slots, 0, GUILD_BANK_MAX_SLOTS * sizeof(Item*));
+
+            NewTab->Name = fields[2].GetCppString();
+            NewTab->Icon = fields[3].GetCppString();
+            NewTab->Text = fields[4].GetCppString();
+
+            m_TabListMap[TabId] = NewTab;
+        }
+
+        if (!fields[6].GetString())                         // tab without items
+            continue;
+
+        uint8 SlotId = fields[5].GetUInt8();
+        uint32 ItemGuid = fields[6].GetUInt32();
+        uint32 ItemEntry = fields[7].GetUInt32();
+
         if (SlotId >= GUILD_BANK_MAX_SLOTS)
         {
             sLog.outError("Guild::LoadGuildBankFromDB: Invalid slot for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid,ItemEntry);
@@ -1220,8 +1220,9 @@ void Guild::LoadGuildBankFromDB()
             continue;
         }
 
+        // data needs to be at first place for Item::LoadFromDB
         Item *pItem = NewItemOrBag(proto);
-        if (!pItem->LoadFromDB(ItemGuid, 0, result))
+        if (!fields[0].GetString() || !pItem->LoadFromDB(ItemGuid, 0, result))
         {
             CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE guildid='%u' AND TabId='%u' AND SlotId='%u'", Id, uint32(TabId), uint32(SlotId));
             sLog.outError("Item GUID %u not found in item_instance, deleting from Guild Bank!", ItemGuid);
@@ -1252,9 +1253,9 @@ void Guild::UnloadGuildBank()
         delete m_TabListMap[i];
     }
     m_TabListMap.clear();
+    m_bankloaded = false;
 
     UnloadGuildBankEventLog();
-    m_bankloaded = false;
 }
 
 // *************************************************
@@ -1476,11 +1477,16 @@ void Guild::LoadBankRightsFromDB(uint32 GuildId)
 // *************************************************
 // Bank log related
 
-void Guild::LoadGuildBankEventLogFromDB()
+// Loaded with the bank, from the result of
+//        0        1         2      3           4            5               6          7
+// SELECT LogGuid, LogEntry, TabId, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' ORDER BY TimeStamp DESC
+// We can't add a limit as in Guild::LoadGuildEventLogFromDB since we fetch both money and bank log and know nothing about the composition
+void Guild::LoadGuildBankEventLogFromDB(QueryResult_AutoPtr result)
 {
-    // We can't add a limit as in Guild::LoadGuildEventLogFromDB since we fetch both money and bank log and know nothing about the composition
-    //                                                     0        1         2      3           4            5               6          7
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT LogGuid, LogEntry, TabId, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' ORDER BY TimeStamp DESC", Id);
+    if (m_bankEventLogLoaded)
+        return;
+
+    m_bankEventLogLoaded = true;
     if (!result)
         return;
 
@@ -1538,11 +1544,13 @@ void Guild::UnloadGuildBankEventLog()
 
     for (int i = 0; i < GUILD_BANK_MAX_TABS; ++i)
         m_GuildBankEventLog_Item[i].clear();
+
+    m_bankEventLogLoaded = false;
 }
 
 void Guild::DisplayGuildBankLogs(WorldSession *session, uint8 TabId)
 {
-    if (TabId > GUILD_BANK_MAX_TABS)
+    if (TabId > GUILD_BANK_MAX_TABS || !m_bankEventLogLoaded)
         return;
 
     if (TabId == GUILD_BANK_MAX_TABS)
@@ -348,8 +348,9 @@ class Guild
         void Query(WorldSession *session);
 
         void UpdateLogoutTime(uint64 guid);
-        // Guild eventlog
-        void   LoadGuildEventLogFromDB();
+        // Guild eventlog, loaded by an async query at the first look (see WorldSession::HandleGuildEventLogOpcode)
+        void   LoadGuildEventLogFromDB(QueryResult_AutoPtr result);
+        bool   IsGuildEventLogLoaded() const { return m_eventlogloaded; }
         void   UnloadGuildEventlog();
         void   DisplayGuildEventlog(WorldSession *session);
         void   LogGuildEvent(uint8 EventType, uint32 PlayerGuid1, uint32 PlayerGuid2, uint8 NewRank);
@@ -379,8 +380,9 @@ class Guild
         uint32 GetBankRights(uint32 rankId, uint8 TabId) const;
         bool   IsMemberHaveRights(uint32 LowGuid, uint8 TabId,uint32 rights) const;
         bool   CanMemberViewTab(uint32 LowGuid, uint8 TabId) const;
-        // Load/unload
-        void   LoadGuildBankFromDB();
+        // Load/unload, the first opening of the bank queries it asynchronously (see WorldSession::SendGuildBankTabsInfo)
+        void   LoadGuildBankFromDB(QueryResult_AutoPtr result);
+        bool   IsGuildBankLoaded() const { return m_bankloaded; }
         void   UnloadGuildBank();
         void   IncOnlineMemberCount() { ++m_onlinemembers; }
         // Money deposit/withdraw
@@ -399,7 +401,8 @@ class Guild
         // rights per day
         void   LoadBankRightsFromDB(uint32 GuildId);
         // logs
-        void   LoadGuildBankEventLogFromDB();
+        void   LoadGuildBankEventLogFromDB(QueryResult_AutoPtr result);
+        bool   IsGuildBankEventLogLoaded() const { return m_bankEventLogLoaded; }
         void   UnloadGuildBankEventLog();
         void   DisplayGuildBankLogs(WorldSession *session, uint8 TabId);
         void   LogBankEvent(uint8 LogEntry, uint8 TabId, uint32 PlayerGuidLow, uint32 ItemOrMoney, uint8 ItemStackCount=0, uint8 DestTabId=0);
@@ -440,6 +443,7 @@ class Guild
 
         bool m_bankloaded;
         bool m_eventlogloaded;
+        bool m_bankEventLogLoaded;
         uint32 m_onlinemembers;
         uint64 guildbank_money;
         uint8 purchased_tabs;
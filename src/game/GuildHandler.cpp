@@ -811,11 +811,83 @@ void WorldSession::HandleGuildEventLogOpcode(WorldPacket& /* recvPacket */)
     if (!pGuild)
         return;
 
+    // first look since the guild was loaded, read the log without holding up the world thread
+    if (!pGuild->IsGuildEventLogLoaded())
+    {
+        AsyncPQuery(&WorldSession::HandleGuildEventLogContinuation, GuildId,
+            "SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY LogGuid DESC LIMIT %u",
+            GuildId, GUILD_EVENTLOG_MAX_ENTRIES);
+        return;
+    }
+
+    pGuild->DisplayGuildEventlog(this);
+}
+
+void WorldSession::HandleGuildEventLogContinuation(QueryResult_AutoPtr result, uint64 GuildId)
+{
+    if (GetPlayer()->GetGuildId() != GuildId)
+        return;
+
+    Guild *pGuild = objmgr.GetGuildById(uint32(GuildId));
+    if (!pGuild)
+        return;
+
+    pGuild->LoadGuildEventLogFromDB(result);
     pGuild->DisplayGuildEventlog(this);
 }
 
 /******  GUILD BANK  *******/
 
+#define GUILD_BANK_EVENTLOG_QUERY "SELECT LogGuid, LogEntry, TabId, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' ORDER BY TimeStamp DESC"
+
+/* Bank and bank log are loaded at the first opening of the bank, the queries resume this session only */
+void WorldSession::SendGuildBankTabsInfo(Guild* pGuild)
+{
+    if (!pGuild->IsGuildBankLoaded())
+    {
+        // data needs to be at first place for Item::LoadFromDB
+        AsyncPQuery(&WorldSession::SendGuildBankTabsInfoContinuation, pGuild->GetId(),
+            "SELECT ii.data, t.TabId, t.TabName, t.TabIcon, t.TabText, gi.SlotId, gi.item_guid, gi.item_entry FROM guild_bank_tab t "
+            "LEFT JOIN guild_bank_item gi ON gi.guildid = t.guildid AND gi.TabId = t.TabId LEFT JOIN item_instance ii ON ii.guid = gi.item_guid "
+            "WHERE t.guildid='%u' ORDER BY t.TabId", pGuild->GetId());
+        return;
+    }
+
+    if (!pGuild->IsGuildBankEventLogLoaded())
+    {
+        AsyncPQuery(&WorldSession::SendGuildBankEventLogContinuation, pGuild->GetId(), GUILD_BANK_EVENTLOG_QUERY, pGuild->GetId());
+        return;
+    }
+
+    pGuild->DisplayGuildBankTabsInfo(this);
+}
+
+void WorldSession::SendGuildBankTabsInfoContinuation(QueryResult_AutoPtr result, uint64 GuildId)
+{
+    if (GetPlayer()->GetGuildId() != GuildId)
+        return;
+
+    Guild *pGuild = objmgr.GetGuildById(uint32(GuildId));
+    if (!pGuild)
+        return;
+
+    pGuild->LoadGuildBankFromDB(result);
+    SendGuildBankTabsInfo(pGuild);
+}
+
+void WorldSession::SendGuildBankEventLogContinuation(QueryResult_AutoPtr result, uint64 GuildId)
+{
+    if (GetPlayer()->GetGuildId() != GuildId)
+        return;
+
+    Guild *pGuild = objmgr.GetGuildById(uint32(GuildId));
+    if (!pGuild)
+        return;
+
+    pGuild->LoadGuildBankEventLogFromDB(result);
+    SendGuildBankTabsInfo(pGuild);
+}
+
 void WorldSession::HandleGuildBankGetMoneyAmount(WorldPacket & /* recv_data */ )
 {
     sLog.outDebug("WORLD: Received (MSG_GUILD_BANK_MONEY_WITHDRAWN)");
@@ -877,7 +949,7 @@ void WorldSession::HandleGuildBankQuery(WorldPacket & recv_data )
     {
         if (Guild *pGuild = objmgr.GetGuildById(GuildId))
         {
-            pGuild->DisplayGuildBankTabsInfo(this);
+            SendGuildBankTabsInfo(pGuild);
             return;
         }
     }
@@ -955,7 +1027,7 @@ void WorldSession::HandleGuildBankDeposit(WorldPacket & recv_data )
     // log
     pGuild->LogBankEvent(GUILD_BANK_LOG_DEPOSIT_MONEY, uint8(0), GetPlayer()->GetGUIDLow(), money);
 
-    pGuild->DisplayGuildBankTabsInfo(this);
+    SendGuildBankTabsInfo(pGuild);
     pGuild->DisplayGuildBankContent(this, 0);
     pGuild->DisplayGuildBankMoneyUpdate();
 }
@@ -1005,7 +1077,7 @@ void WorldSession::HandleGuildBankWithdraw(WorldPacket & recv_data )
     pGuild->LogBankEvent(GUILD_BANK_LOG_WITHDRAW_MONEY, uint8(0), GetPlayer()->GetGUIDLow(), money);
 
     pGuild->SendMoneyInfo(this, GetPlayer()->GetGUIDLow());
-    pGuild->DisplayGuildBankTabsInfo(this);
+    SendGuildBankTabsInfo(pGuild);
     pGuild->DisplayGuildBankContent(this, 0);
     pGuild->DisplayGuildBankMoneyUpdate();
 }
@@ -1549,7 +1621,7 @@ void WorldSession::HandleGuildBankBuyTab(WorldPacket & recv_data )
     pGuild->SetBankMoneyPerDay(GetPlayer()->GetRank(), WITHDRAW_MONEY_UNLIMITED);
     pGuild->SetBankRightsAndSlots(GetPlayer()->GetRank(), TabId, GUILD_BANK_RIGHT_FULL, WITHDRAW_SLOT_UNLIMITED, true);
     pGuild->Roster(this);
-    pGuild->DisplayGuildBankTabsInfo(this);
+    SendGuildBankTabsInfo(pGuild);
 }
 
 void WorldSession::HandleGuildBankModifyTab(WorldPacket & recv_data )
@@ -1584,7 +1656,7 @@ void WorldSession::HandleGuildBankModifyTab(WorldPacket & recv_data )
         return;
 
     pGuild->SetGuildBankTabInfo(TabId, Name, IconIndex);
-    pGuild->DisplayGuildBankTabsInfo(this);
+    SendGuildBankTabsInfo(pGuild);
     pGuild->DisplayGuildBankContent(this, TabId);
 }
 
@@ -1603,9 +1675,30 @@ void WorldSession::HandleGuildBankLog(WorldPacket & recv_data )
     uint8 TabId;
     recv_data >> TabId;
 
+    // normally read when the bank was opened, the tab goes along in the high half of the parameter
+    if (!pGuild->IsGuildBankEventLogLoaded())
+    {
+        AsyncPQuery(&WorldSession::HandleGuildBankLogContinuation, (uint64(TabId) << 32) | GuildId, GUILD_BANK_EVENTLOG_QUERY, GuildId);
+        return;
+    }
+
     pGuild->DisplayGuildBankLogs(this, TabId);
 }
 
+void WorldSession::HandleGuildBankLogContinuation(QueryResult_AutoPtr result, uint64 param)
+{
+    uint32 GuildId = uint32(param);
+    if (GetPlayer()->GetGuildId() != GuildId)
+        return;
+
+    Guild *pGuild = objmgr.GetGuildById(GuildId);
+    if (!pGuild)
+        return;
+
+    pGuild->LoadGuildBankEventLogFromDB(result);
+    pGuild->DisplayGuildBankLogs(this, uint8(param >> 32));
+}
+
 void WorldSession::HandleGuildBankTabText(WorldPacket &recv_data)
 {
     sLog.outDebug("WORLD: Received MSG_QUERY_GUILD_BANK_TEXT");
@@ -287,6 +287,12 @@ void Item::UpdateDuration(Player* owner, uint32 diff)
     SetState(ITEM_CHANGED,owner);                                 // save new time in database
 }
 
+void Item::AppendDataString(std::ostringstream& ss) const
+{
+    for (uint16 i = 0; i < m_valuesCount; i++ )
+        ss << GetUInt32Value(i) << " ";
+}
+
 void Item::SaveToDB()
 {
     uint32 guid = GetGUIDLow();
@@ -297,8 +303,7 @@ void Item::SaveToDB()
             CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", guid);
             std::ostringstream ss;
             ss << "INSERT INTO item_instance (guid,owner_guid,data) VALUES (" << guid << "," << GUID_LOPART(GetOwnerGUID()) << ",'";
-            for (uint16 i = 0; i < m_valuesCount; i++ )
-                ss << GetUInt32Value(i) << " ";
+            AppendDataString(ss);
             ss << "' )";
             CharacterDatabase.Execute(ss.str().c_str());
         } break;
@@ -306,8 +311,7 @@ void Item::SaveToDB()
         {
             std::ostringstream ss;
             ss << "UPDATE item_instance SET data = '";
-            for (uint16 i = 0; i < m_valuesCount; i++ )
-                ss << GetUInt32Value(i) << " ";
+            AppendDataString(ss);
             ss << "', owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
 
             CharacterDatabase.Execute(ss.str().c_str());
@@ -331,6 +335,90 @@ void Item::SaveToDB()
     SetState(ITEM_UNCHANGED);
 }
 
+void ItemSaveBatch::SaveInventory(Item* item, uint32 owner_guid, uint32 bag_guid)
+{
+    std::ostringstream ss;
+    ss << "(" << owner_guid << "," << bag_guid << "," << uint32(item->GetSlot()) << "," << item->GetGUIDLow() << "," << item->GetEntry() << ")";
+    m_inventoryRows.push_back(ss.str());
+}
+
+void ItemSaveBatch::DeleteInventory(Item* item)
+{
+    m_deletedInventory.push_back(item->GetGUIDLow());
+}
+
+void ItemSaveBatch::SaveItem(Item* item)
+{
+    switch (item->GetState())
+    {
+        case ITEM_NEW:
+        case ITEM_CHANGED:
+        {
+            std::ostringstream ss;
+            ss << "(" << item->GetGUIDLow() << "," << GUID_LOPART(item->GetOwnerGUID()) << ",'";
+            item->AppendDataString(ss);
+            ss << "')";
+            m_instanceRows.push_back(ss.str());
+
+            if (item->GetState() == ITEM_CHANGED && item->HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
+                CharacterDatabase.PExecute("UPDATE character_gifts SET guid = '%u' WHERE item_guid = '%u'", GUID_LOPART(item->GetOwnerGUID()), item->GetGUIDLow());
+        } break;
+        case ITEM_REMOVED:
+        {
+            if (item->GetUInt32Value(ITEM_FIELD_ITEM_TEXT_ID) > 0 )
+                CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", item->GetUInt32Value(ITEM_FIELD_ITEM_TEXT_ID));
+            m_deletedInstances.push_back(item->GetGUIDLow());
+            if (item->HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
+                CharacterDatabase.PExecute("DELETE FROM character_gifts WHERE item_guid = '%u'", item->GetGUIDLow());
+            delete item;
+            return;
+        }
+        case ITEM_UNCHANGED:
+            return;
+    }
+    item->SetState(ITEM_UNCHANGED);
+}
+
+void ItemSaveBatch::Execute()
+{
+    ExecuteDelete("character_inventory", "item", m_deletedInventory);
+    ExecuteDelete("item_instance", "guid", m_deletedInstances);
+    ExecuteUpsert("INSERT INTO item_instance (guid,owner_guid,data) VALUES ",
+        " ON DUPLICATE KEY UPDATE owner_guid = VALUES(owner_guid), data = VALUES(data)", m_instanceRows);
+    ExecuteUpsert("INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ",
+        " ON DUPLICATE KEY UPDATE guid = VALUES(guid), bag = VALUES(bag), slot = VALUES(slot), item_template = VALUES(item_template)", m_inventoryRows);
+}
+
+void ItemSaveBatch::ExecuteDelete(char const* table, char const* column, std::vector<uint32>& guids)
+{
+    for (size_t first = 0; first < guids.size(); first += ITEM_SAVE_BATCH_ROWS)
+    {
+        size_t last = std::min(first + ITEM_SAVE_BATCH_ROWS, guids.size());
+        std::ostringstream ss;
+        ss << "DELETE FROM " << table << " WHERE " << column << " IN (";
+        for (size_t i = first; i < last; ++i)
+            ss << (i != first ? "," : "") << guids[i];
+        ss << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+    guids.clear();
+}
+
+void ItemSaveBatch::ExecuteUpsert(char const* insert, char const* update, std::vector<std::string>& rows)
+{
+    for (size_t first = 0; first < rows.size(); first += ITEM_SAVE_BATCH_ROWS)
+    {
+        size_t last = std::min(first + ITEM_SAVE_BATCH_ROWS, rows.size());
+        std::ostringstream ss;
+        ss << insert;
+        for (size_t i = first; i < last; ++i)
+            ss << (i != first ? "," : "") << rows[i];
+        ss << update;
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+    rows.clear();
+}
+
 bool Item::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult_AutoPtr result)
 {
     // create item before any checks for store correct guid
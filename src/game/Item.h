@@ -215,6 +215,7 @@ class NEO_DLL_SPEC Item : public Object
         bool IsBindedNotWith(uint64 guid) const { return IsSoulBound() && GetOwnerGUID()!= guid; }
         bool IsBoundByEnchant() const;
         virtual void SaveToDB();
+        void AppendDataString(std::ostringstream& ss) const;  // the values as stored in item_instance.data
         virtual bool LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult_AutoPtr result = QueryResult_AutoPtr(NULL));
         virtual void DeleteFromDB();
         void DeleteFromInventoryDB();
@@ -297,5 +298,33 @@ class NEO_DLL_SPEC Item : public Object
         int16 uQueuePos;
         bool mb_in_trade;                                   // true if item is currently in trade-window
 };
+
+// max. rows written by one statement of ItemSaveBatch
+#define ITEM_SAVE_BATCH_ROWS 100
+
+/*
+ * Collects the item_instance and character_inventory changes of one inventory save
+ * and writes them with a few multi-row statements instead of one or two per item.
+ * Use it inside the save transaction and call Execute() at the end.
+ */
+class ItemSaveBatch
+{
+    public:
+        // inventory record of a new or moved item
+        void SaveInventory(Item* item, uint32 owner_guid, uint32 bag_guid);
+        void DeleteInventory(Item* item);
+        // same as Item::SaveToDB, deletes removed items
+        void SaveItem(Item* item);
+        void Execute();
+
+    private:
+        static void ExecuteDelete(char const* table, char const* column, std::vector<uint32>& guids);
+        static void ExecuteUpsert(char const* insert, char const* update, std::vector<std::string>& rows);
+
+        std::vector<uint32> m_deletedInventory;
+        std::vector<uint32> m_deletedInstances;
+        std::vector<std::string> m_inventoryRows;
+        std::vector<std::string> m_instanceRows;
+};
 #endif
 
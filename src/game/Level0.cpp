@@ -108,6 +108,11 @@ bool ChatHandler::HandleServerInfoCommand(const char* /*args*/)
     PSendSysMessage(LANG_CONNECTED_USERS, activeClientsNum, maxActiveClientsNum, queuedClientsNum, maxQueuedClientsNum);
     PSendSysMessage(LANG_UPTIME, str.c_str());
     PSendSysMessage("Update time diff: %u.", updateTime);
+    PSendSysMessage("Autosaves: %u done, %u waiting (%u waiting ticks), character DB queue: %u.",
+        sWorld.GetAutoSaveCount(), sWorld.GetAutoSaveQueueSize(), sWorld.GetAutoSaveDeferredCount(),
+        uint32(CharacterDatabase.GetDelayQueueSize()));
+    PSendSysMessage("Map packets: %u in map threads, %u in world thread, %u world packets delayed a tick by a map.",
+        sWorld.GetMapPacketsInMap(), sWorld.GetMapPacketsInWorld(), sWorld.GetWorldPacketsDeferred());
 
     return true;
 }
@@ -116,6 +116,7 @@ void WorldSession::HandleAutostoreLootItemOpcode(WorldPacket & recv_data)
     if (msg == EQUIP_ERR_OK)
     {
         Item * newitem = player->StoreNewItem(dest, item->itemid, true, item->randomPropertyId);
+        player->SetSignificantChanges();
 
         if (qitem)
         {
@@ -490,6 +491,7 @@ void WorldSession::HandleLootMasterGiveOpcode(WorldPacket & recv_data)
 
     // not move item from loot to target inventory
     Item * newitem = target->StoreNewItem(dest, item.itemid, true, item.randomPropertyId);
+    target->SetSignificantChanges();
     target->SendNewItem(newitem, uint32(item.count), false, false, true);
 
     // mark as looted
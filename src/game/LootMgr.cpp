@@ -63,13 +63,25 @@ class LootTemplate::LootGroup                               // A set of loot def
         void Verify(LootStore const& lootstore, uint32 id, uint32 group_id) const;
         void CollectLootIds(LootIdSet& set) const;
         void CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_set) const;
+        void Compile();                                     // Builds the alias table, after the last AddEntry
+        void CompareRolls(uint32 rolls, LootRollCounts& counts) const;
+                                                            // Counts the outcomes of Roll() and SequentialRoll()
     private:
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // Walker alias table over all outcomes of Roll(), so a roll costs one random number whatever the group size
+        std::vector<LootStoreItem const*> Outcomes;         // NULL for an empty drop
+        std::vector<float> AliasChance;                     // chance to keep the column's own outcome
+        std::vector<uint32> Alias;                          // outcome taken otherwise
+
         LootStoreItem const * Roll() const;                 // Rolls an item from the group, returns NULL if all miss their chances
+        LootStoreItem const * SequentialRoll() const;       // The roll Compile() reproduces, kept to check the table against
 };
 
+// random numbers for not grouped entries are taken in chunks of this size
+#define LOOT_ROLL_BATCH 32
+
 //Remove all data and free all memory
 void LootStore::Clear()
 {
@@ -157,6 +169,9 @@ void LootStore::LoadLootTable()
 
         Verify();                                           // Checks validity of the loot store
 
+        for (LootTemplateMap::const_iterator i = m_LootTemplates.begin(); i != m_LootTemplates.end(); ++i)
+            i->second->Compile();
+
         sLog.outString("");
         sLog.outString(">> Loaded %u loot definitions (%d templates)", count, m_LootTemplates.size());
     }
@@ -502,30 +517,34 @@ void Loot::NotifyItemRemoved(uint8 lootIndex)
 {
     // notify all players that are looting this that the item was removed
     // convert the index to the slot the player sees
-    std::set<uint64>::iterator i_next;
-    for (std::set<uint64>::iterator i = PlayersLooting.begin(); i != PlayersLooting.end(); i = i_next)
+    for (size_t i = 0; i < PlayersLooting.size();)
     {
-        i_next = i;
-        ++i_next;
-        if (Player* pl = ObjectAccessor::FindPlayer(*i))
+        if (Player* pl = ObjectAccessor::FindPlayer(PlayersLooting[i]))
             pl->SendNotifyLootItemRemoved(lootIndex);
         else
-            PlayersLooting.erase(i);
+        {
+            PlayersLooting[i] = PlayersLooting.back();
+            PlayersLooting.pop_back();
+            continue;
+        }
+        ++i;
     }
 }
 
 void Loot::NotifyMoneyRemoved()
 {
     // notify all players that are looting this that the money was removed
-    std::set<uint64>::iterator i_next;
-    for (std::set<uint64>::iterator i = PlayersLooting.begin(); i != PlayersLooting.end(); i = i_next)
+    for (size_t i = 0; i < PlayersLooting.size();)
     {
-        i_next = i;
-        ++i_next;
-        if (Player* pl = ObjectAccessor::FindPlayer(*i))
+        if (Player* pl = ObjectAccessor::FindPlayer(PlayersLooting[i]))
             pl->SendNotifyLootMoneyRemoved();
         else
-            PlayersLooting.erase(i);
+        {
+            PlayersLooting[i] = PlayersLooting.back();
+            PlayersLooting.pop_back();
+            continue;
+        }
+        ++i;
     }
 }
 
@@ -536,12 +555,9 @@ void Loot::NotifyQuestItemRemoved(uint8 questIndex)
     // (other questitems can be looted by each group member)
     // bit inefficient but isn't called often
 
-    std::set<uint64>::iterator i_next;
-    for (std::set<uint64>::iterator i = PlayersLooting.begin(); i != PlayersLooting.end(); i = i_next)
+    for (size_t i = 0; i < PlayersLooting.size();)
     {
-        i_next = i;
-        ++i_next;
-        if (Player* pl = ObjectAccessor::FindPlayer(*i))
+        if (Player* pl = ObjectAccessor::FindPlayer(PlayersLooting[i]))
         {
             QuestItemMap::iterator pq = PlayerQuestItems.find(pl->GetGUIDLow());
             if (pq != PlayerQuestItems.end() && pq->second)
@@ -559,7 +575,12 @@ void Loot::NotifyQuestItemRemoved(uint8 questIndex)
             }
         }
         else
-            PlayersLooting.erase(i);
+        {
+            PlayersLooting[i] = PlayersLooting.back();
+            PlayersLooting.pop_back();
+            continue;
+        }
+        ++i;
     }
 }
 
@@ -771,17 +792,28 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const * LootTemplate::LootGroup::Roll() const
+{
+    if (Outcomes.empty())
+        return NULL;
+
+    double pick = rand_norm() * Outcomes.size();
+    uint32 column = std::min(uint32(pick), uint32(Outcomes.size() - 1));
+
+    return Outcomes[pick - column < AliasChance[column] ? column : Alias[column]];
+}
+
+// Walks the entries in DB order the way rolls were done before the alias table
+LootStoreItem const * LootTemplate::LootGroup::SequentialRoll() const
 {
     if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
     {
         float Roll = rand_chance();
 
-        for (uint32 i=0; i<ExplicitlyChanced.size(); ++i)    //check each explicitly chanced entry in the template and modify its chance based on quality.
+        for (uint32 i=0; i<ExplicitlyChanced.size(); ++i)
         {
             if (ExplicitlyChanced[i].chance>=100.f)
                 return &ExplicitlyChanced[i];
 
-            ItemPrototype const *pProto = objmgr.GetItemPrototype(ExplicitlyChanced[i].itemid);
             Roll -= ExplicitlyChanced[i].chance;
             if (Roll < 0)
                 return &ExplicitlyChanced[i];
@@ -793,6 +825,83 @@ LootStoreItem const * LootTemplate::LootGroup::Roll() const
     return NULL;                                            // Empty drop from the group
 }
 
+void LootTemplate::LootGroup::CompareRolls(uint32 rolls, LootRollCounts& counts) const
+{
+    for (uint32 i = 0; i < rolls; ++i)
+    {
+        LootStoreItem const* item = SequentialRoll();
+        ++counts[item ? item->itemid : 0].first;
+
+        item = Roll();
+        ++counts[item ? item->itemid : 0].second;
+    }
+}
+
+// The alias table gives every outcome exactly the chance the sequential roll used to give it:
+// explicitly chanced entries take their chance in DB order until 100% are used up (an entry
+// of 100% or more takes the whole rest), equal chanced entries share what is left, else nothing drops
+void LootTemplate::LootGroup::Compile()
+{
+    std::vector<double> weights;
+    Outcomes.clear();
+
+    double used = 0.0;
+    for (LootStoreItemList::const_iterator i = ExplicitlyChanced.begin(); i != ExplicitlyChanced.end() && used < 100.0; ++i)
+    {
+        double weight = i->chance >= 100.f ? 100.0 - used : std::min(double(i->chance), 100.0 - used);
+        used += weight;
+        if (weight <= 0.0)
+            continue;
+
+        Outcomes.push_back(&*i);
+        weights.push_back(weight);
+    }
+
+    if (used < 100.0)
+    {
+        if (!EqualChanced.empty())
+        {
+            for (LootStoreItemList::const_iterator i = EqualChanced.begin(); i != EqualChanced.end(); ++i)
+            {
+                Outcomes.push_back(&*i);
+                weights.push_back((100.0 - used) / EqualChanced.size());
+            }
+        }
+        else if (!Outcomes.empty())
+        {
+            Outcomes.push_back(NULL);
+            weights.push_back(100.0 - used);
+        }
+    }
+
+    // Vose's method
+    uint32 n = Outcomes.size();
+    AliasChance.assign(n, 1.0f);
+    Alias.resize(n);
+    for (uint32 i = 0; i < n; ++i)
+        Alias[i] = i;
+
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < n; ++i)
+    {
+        weights[i] = weights[i] * n / 100.0;
+        (weights[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 s = small.back(); small.pop_back();
+        uint32 l = large.back(); large.pop_back();
+
+        AliasChance[s] = float(weights[s]);
+        Alias[s] = l;
+
+        weights[l] = (weights[l] + weights[s]) - 1.0;
+        (weights[l] < 1.0 ? small : large).push_back(l);
+    }
+    // whatever is left over is 1.0 apart from rounding errors and keeps its own outcome
+}
+
 // True if group includes at least 1 quest drop entry
 bool LootTemplate::LootGroup::HasQuestDrop() const
 {
@@ -904,6 +1013,40 @@ void LootTemplate::AddEntry(LootStoreItem& item)
         Entries.push_back(item);
 }
 
+// Resolves chance modifiers of not grouped entries and builds the group tables
+void LootTemplate::Compile()
+{
+    EntryRolls.resize(Entries.size());
+    for (size_t i = 0; i < Entries.size(); ++i)
+    {
+        LootStoreItem const& entry = Entries[i];
+        EntryRoll& roll = EntryRolls[i];
+
+        roll.chance = entry.chance;
+        roll.always = entry.chance >= 100.f;
+
+        if (entry.mincountOrRef < 0)                        // reference case
+            roll.rate = RATE_DROP_ITEM_REFERENCED;
+        else if (ItemPrototype const *pProto = objmgr.GetItemPrototype(entry.itemid))
+            roll.rate = qualityToRate[pProto->Quality];
+        else
+            roll.rate = -1;
+    }
+
+    for (LootGroups::iterator i = Groups.begin(); i != Groups.end(); ++i)
+        i->Compile();
+}
+
+// Rolls a group with its alias table and the old sequential roll, false if there is no such group
+bool LootTemplate::CompareGroupRolls(uint8 groupId, uint32 rolls, LootRollCounts& counts) const
+{
+    if (!groupId || groupId > Groups.size())
+        return false;
+
+    Groups[groupId-1].CompareRolls(rolls, counts);
+    return true;
+}
+
 // Rolls for every item in the template and adds the rolled items the the loot
 void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) const
 {
@@ -916,12 +1059,20 @@ void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) co
         return;
     }
 
-    // Rolling non-grouped items
-    for (LootStoreItemList::const_iterator i = Entries.begin() ; i != Entries.end() ; ++i )
+    // Rolling non-grouped items, same as LootStoreItem::Roll() with the random numbers taken in chunks
+    double rolls[LOOT_ROLL_BATCH];
+    for (size_t n = 0; n < Entries.size(); ++n)
     {
-        if (!i->Roll() )
+        if (n % LOOT_ROLL_BATCH == 0)
+            rand_chance_batch(rolls, std::min<size_t>(LOOT_ROLL_BATCH, Entries.size() - n));
+
+        EntryRoll const& roll = EntryRolls[n];
+        float rate = roll.rate >= 0 ? sWorld.getRate(Rates(roll.rate)) : 1.0f;
+        if (!roll.always && !(roll.chance * rate > rolls[n % LOOT_ROLL_BATCH]))
             continue;                                       // Bad luck for the entry
 
+        LootStoreItemList::const_iterator i = Entries.begin() + n;
+
         if (i->mincountOrRef < 0)                           // References processing
         {
             LootTemplate const* Referenced = LootTemplates_Reference.GetLootFor(-i->mincountOrRef);
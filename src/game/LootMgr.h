@@ -24,7 +24,9 @@
 #include "ItemEnchantmentMgr.h"
 #include "ByteBuffer.h"
 #include "Utilities/LinkedReference/RefManager.h"
+#include "Utilities/ObjectPool.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -119,12 +121,18 @@ struct QuestItem
 struct Loot;
 class LootTemplate;
 
-typedef std::vector<QuestItem> QuestItemList;
+// per player item lists of a loot, created and released with every looted corpse
+struct QuestItemList : public std::vector<QuestItem>
+{
+    DECLARE_OBJECT_POOL(QuestItemList)
+};
+
 typedef std::map<uint32, QuestItemList *> QuestItemMap;
 typedef std::vector<LootStoreItem> LootStoreItemList;
 typedef UNORDERED_MAP<uint32, LootTemplate*> LootTemplateMap;
 
 typedef std::set<uint32> LootIdSet;
+typedef std::map<uint32, std::pair<uint32, uint32> > LootRollCounts;  // item id (0 for nothing) -> sequential, alias table hits
 
 class LootStore
 {
@@ -175,8 +183,20 @@ class LootTemplate
         // Checks integrity of the template
         void Verify(LootStore const& store, uint32 Id) const;
         void CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_set) const;
+        // Prepares the roll tables, must be called after the last AddEntry
+        void Compile();
+        // Rolls a group both ways and counts the outcomes (.debug lootgroup)
+        bool CompareGroupRolls(uint8 groupId, uint32 rolls, LootRollCounts& counts) const;
     private:
+        struct EntryRoll                                    // What LootStoreItem::Roll() needs, resolved at load
+        {
+            float chance;
+            int8  rate;                                     // Rates value the chance is multiplied with, -1 for none
+            bool  always;                                   // chance >= 100%, no roll needed
+        };
+
         LootStoreItemList Entries;                          // not grouped only
+        std::vector<EntryRoll> EntryRolls;                  // same order as Entries
         LootGroups        Groups;                           // groups have own (optimised) processing, grouped entries go there
 };
 
@@ -254,14 +274,35 @@ struct Loot
         i_LootValidatorRefManager.clearReferences();
     }
 
+    // clear() that also gives back the memory, for loot that is not going to be refilled soon
+    void release()
+    {
+        clear();
+        std::vector<LootItem>().swap(items);
+        std::vector<LootItem>().swap(quest_items);
+        std::vector<uint64>().swap(PlayersLooting);
+    }
+
     bool empty() const { return items.empty() && gold == 0; }
     bool isLooted() const { return gold == 0 && unlootedCount == 0; }
 
     void NotifyItemRemoved(uint8 lootIndex);
     void NotifyQuestItemRemoved(uint8 questIndex);
     void NotifyMoneyRemoved();
-    void AddLooter(uint64 GUID) { PlayersLooting.insert(GUID); }
-    void RemoveLooter(uint64 GUID) { PlayersLooting.erase(GUID); }
+    void AddLooter(uint64 GUID)
+    {
+        if (std::find(PlayersLooting.begin(), PlayersLooting.end(), GUID) == PlayersLooting.end())
+            PlayersLooting.push_back(GUID);
+    }
+    void RemoveLooter(uint64 GUID)
+    {
+        std::vector<uint64>::iterator itr = std::find(PlayersLooting.begin(), PlayersLooting.end(), GUID);
+        if (itr != PlayersLooting.end())
+        {
+            *itr = PlayersLooting.back();
+            PlayersLooting.pop_back();
+        }
+    }
 
     void generateMoneyLoot(uint32 minAmount, uint32 maxAmount);
     void FillLoot(uint32 loot_id, LootStore const& store, Player* loot_owner);
@@ -273,7 +314,7 @@ struct Loot
 	uint32 GetMaxSlotInLootFor(Player* player) const;
 	
 	private:
-        std::set<uint64> PlayersLooting;
+        std::vector<uint64> PlayersLooting;                 // rarely more than a group, a vector beats a tree here
         QuestItemMap PlayerQuestItems;
         QuestItemMap PlayerFFAItems;
         QuestItemMap PlayerNonQuestNonFFAConditionalItems;
@@ -304,6 +345,7 @@ extern LootStore LootTemplates_Pickpocketing;
 extern LootStore LootTemplates_Skinning;
 extern LootStore LootTemplates_Disenchant;
 extern LootStore LootTemplates_Prospecting;
+extern LootStore LootTemplates_Reference;
 
 void LoadLootTemplates_Creature();
 void LoadLootTemplates_Fishing();
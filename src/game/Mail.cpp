@@ -147,7 +147,7 @@ void WorldSession::HandleSendMail(WorldPacket & recv_data )
     Player *receive = objmgr.GetPlayer(rc);
 
     uint32 rc_team = 0;
-    uint8 mails_count = 0;                                  //do not allow to send to one player more than 100 mails
+    uint32 mails_count = 0;                                 //do not allow to send to one player more than 100 mails
 
     if (receive)
     {
@@ -157,12 +157,7 @@ void WorldSession::HandleSendMail(WorldPacket & recv_data )
     else
     {
         rc_team = objmgr.GetPlayerTeamByGUID(rc);
-        QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT COUNT(*) FROM mail WHERE receiver = '%u'", GUID_LOPART(rc));
-        if (result)
-        {
-            Field *fields = result->Fetch();
-            mails_count = fields[0].GetUInt32();
-        }
+        mails_count = objmgr.GetOfflineMailCount(GUID_LOPART(rc));
     }
     //do not allow to have more than 100 mails in mailbox.. mails count is in opcode uint8!!! - so max can be 255..
     if (mails_count > 100)
@@ -862,8 +857,13 @@ void WorldSession::SendMailTo(Player* receiver, uint8 messageType, uint8 station
         else if (mi)
             mi->deleteIncludedItems();
     }
-    else if (mi)
-        mi->deleteIncludedItems();
+    else
+    {
+        objmgr.ModifyOfflineMailCount(receiver_guidlow, 1);
+
+        if (mi)
+            mi->deleteIncludedItems();
+    }
 
    
 }
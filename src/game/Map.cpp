@@ -42,6 +42,7 @@
 #include "VMapFactory.h"
 
 #include <fstream>
+#include <algorithm>
 #include <search.h>
 
 #define DEFAULT_GRID_EXPIRY     300
@@ -52,6 +53,9 @@ GridState* si_GridStates[MAX_GRID_STATE];
 Map::~Map()
 {
     UnloadAll();
+
+    // the sources of not yet executed steps are gone with the map
+    sWorld.ScriptActionDone(long(m_scriptSchedule.size()));
 }
 
 bool Map::ExistMap(uint32 mapid,int x,int y)
@@ -152,6 +156,16 @@ void Map::LoadMap(uint32 mapid, uint32 instanceid, int x,int y)
         GridMaps[x][y]=NULL;
     }
 
+    // terrain the grid preloader already read in the background
+    if (GridMapLoader* loader = MapManager::Instance().GetGridMapLoader())
+    {
+        if (GridMap* gridMap = loader->Take(mapid, x, y))
+        {
+            GridMaps[x][y] = gridMap;
+            return;
+        }
+    }
+
     // map file name
     char *tmp=NULL;
     // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
@@ -207,6 +221,12 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
             setNGrid(NULL, idx, j);
         }
     }
+
+    // with a fixed seed the map rolls the same numbers on every run, whatever thread updates it
+    if (uint32 seed = GetRandomSeed())
+        mtRand.Seed((uint64(seed) << 32) ^ (uint64(id) << 24) ^ InstanceId);
+    else                                                    // global generator: the member rand32() would read the unseeded mtRand
+        mtRand.Seed((uint64(::rand32()) << 32) | uint32(::rand32()));
 }
 
 // Template specialization of utility methods
@@ -456,6 +476,71 @@ void Map::LoadGrid(float x, float y)
     EnsureGridLoaded(cell);
 }
 
+void Map::QueueGridPreload(float x, float y, float dx, float dy)
+{
+    // nothing would ever drain the queue
+    if (!sWorld.getConfig(CONFIG_GRID_PRELOAD_PER_TICK))
+        return;
+
+    float dist = sqrt(dx*dx + dy*dy);
+    if (dist < 0.1f)
+        return;
+
+    // walk ahead along the movement direction in half grid steps and queue every not loaded grid
+    float range = float(sWorld.getConfig(CONFIG_GRID_PRELOAD_DISTANCE));
+    for (float step = SIZE_OF_GRIDS/2; step <= range; step += SIZE_OF_GRIDS/2)
+    {
+        float px = x + dx/dist*step;
+        float py = y + dy/dist*step;
+        if (!Neo::IsValidMapCoord(px, py))
+            break;
+
+        GridPair p = Neo::ComputeGridPair(px, py);
+        if (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord))
+            continue;
+
+        uint32 idx = p.x_coord*MAX_NUMBER_OF_GRIDS + p.y_coord;
+        if (!i_gridPreloadQueued.test(idx))
+        {
+            i_gridPreloadQueued.set(idx);
+            i_gridsToPreload.push_back(p);
+
+            // start reading the terrain file now, instances share the base map's terrain and read it on load
+            if (!i_InstanceId && !GridMaps[63-p.x_coord][63-p.y_coord])
+                if (GridMapLoader* loader = MapManager::Instance().GetGridMapLoader())
+                    loader->Request(i_id, 63-p.x_coord, 63-p.y_coord);
+        }
+    }
+}
+
+void Map::ProcessGridPreloadQueue()
+{
+    GridMapLoader* loader = i_InstanceId ? NULL : MapManager::Instance().GetGridMapLoader();
+    for (uint32 count = sWorld.getConfig(CONFIG_GRID_PRELOAD_PER_TICK); count && !i_gridsToPreload.empty(); i_gridsToPreload.pop_front())
+    {
+        GridPair p = i_gridsToPreload.front();
+        if (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord))
+        {
+            i_gridPreloadQueued.reset(p.x_coord*MAX_NUMBER_OF_GRIDS + p.y_coord);
+            continue;
+        }
+
+        // the terrain is still read in the background, loading now would read it again here
+        if (loader && loader->IsReading(i_id, 63-p.x_coord, 63-p.y_coord))
+            break;
+
+        i_gridPreloadQueued.reset(p.x_coord*MAX_NUMBER_OF_GRIDS + p.y_coord);
+
+        // load the grid through its center cell
+        Cell cell(CellPair(p.x_coord*MAX_NUMBER_OF_CELLS + MAX_NUMBER_OF_CELLS/2, p.y_coord*MAX_NUMBER_OF_CELLS + MAX_NUMBER_OF_CELLS/2));
+        DEBUG_LOG("Preloading grid[%u,%u] for map %u", p.x_coord, p.y_coord, i_id);
+        EnsureGridLoaded(cell);
+        // give the player enough time to arrive before the grid may unload again
+        ResetGridExpiry(*getNGrid(p.x_coord, p.y_coord));
+        --count;
+    }
+}
+
 bool Map::Add(Player *player)
 {
     player->GetMapRef().link(this, player);
@@ -608,18 +693,54 @@ bool Map::loaded(const GridPair &p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
+bool Map::GetVisitCellRange(float x, float y, float radius, CellPair &begin_cell, CellPair &end_cell)
+{
+    float x_off, y_off;
+    CellPair standing_cell(Neo::ComputeCellPair(x, y, x_off, y_off));
+    if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+        return false;
+
+    // same range as Cell::Visit with radius
+    begin_cell = standing_cell;
+    end_cell = standing_cell;
+    if (CENTER_GRID_CELL_OFFSET + x_off < radius)
+        begin_cell << 1;
+    if (CENTER_GRID_CELL_OFFSET + y_off < radius)
+        begin_cell -= 1;
+    if (CENTER_GRID_CELL_OFFSET - x_off < radius)
+        end_cell >> 1;
+    if (CENTER_GRID_CELL_OFFSET - y_off < radius)
+        end_cell += 1;
+    return true;
+}
+
+// orders the units to notify by the cell they stand in
+struct RelocationCellOrder
+{
+    static uint32 CellId(Unit const* u)
+    {
+        CellPair p(Neo::ComputeCellPair(u->GetPositionX(), u->GetPositionY()));
+        return p.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + p.x_coord;
+    }
+
+    bool operator()(Unit const* a, Unit const* b) const { return CellId(a) < CellId(b); }
+};
+
 void Map::RelocationNotify()
 {
-    //Move backlog to notify list
+    //Move backlog to notify list, creatures are found in the map's own table
     for (std::vector<uint64>::iterator iter = i_unitsToNotifyBacklog.begin(); iter != i_unitsToNotifyBacklog.end(); ++iter)
     {
-        if (Unit *unit = ObjectAccessor::GetObjectInWorld(*iter, (Unit*)NULL))
-        {
+        Unit *unit = IS_CREATURE_GUID(*iter) ? GetCreatureInMap(*iter) : ObjectAccessor::GetObjectInWorld(*iter, (Unit*)NULL);
+        if (unit)
             i_unitsToNotify.push_back(unit);
-        }
     }
     i_unitsToNotifyBacklog.clear();
 
+    // units moving together (raids, pulled packs) then walk the same cells one after another
+    if (i_unitsToNotify.size() > 1)
+        std::sort(i_unitsToNotify.begin(), i_unitsToNotify.end(), RelocationCellOrder());
+
     //Notify
     for (std::vector<Unit*>::iterator iter = i_unitsToNotify.begin(); iter != i_unitsToNotify.end(); ++iter)
     {
@@ -633,8 +754,9 @@ void Map::RelocationNotify()
         float dist = abs(unit->GetPositionX() - unit->oldX) + abs(unit->GetPositionY() - unit->oldY);
         if (dist > 10.0f)
         {
+            // cells the walk at the new position reaches, shared vision viewers included, are updated by the relocation notifier
             Neo::VisibleChangesNotifier notifier(*unit);
-            VisitWorld(unit->oldX, unit->oldY, World::GetMaxVisibleDistance(), notifier);
+            VisitWorldExcept(unit->oldX, unit->oldY, unit->GetPositionX(), unit->GetPositionY(), World::GetMaxVisibleDistance(), notifier);
             dist = 0;
         }
 
@@ -657,6 +779,61 @@ void Map::RelocationNotify()
     i_unitsToNotify.clear();
 }
 
+void Map::UpdateInterest(WorldObject* obj)
+{
+    CellPair standing_cell(Neo::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
+
+    // Check for correctness of standing_cell, it also avoids problems with update_cell
+    if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        RemoveInterest(obj);
+        return;
+    }
+
+    uint32 cell_id = (standing_cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + standing_cell.x_coord;
+    if (cell_id == obj->m_interestCell)
+        return;
+
+    RemoveInterest(obj);
+    obj->m_interestCell = cell_id;
+    ChangeInterest(standing_cell, 1);
+}
+
+void Map::RemoveInterest(WorldObject* obj)
+{
+    if (obj->m_interestCell == NO_INTEREST_CELL)
+        return;
+
+    CellPair standing_cell(obj->m_interestCell % TOTAL_NUMBER_OF_CELLS_PER_MAP, obj->m_interestCell / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+    obj->m_interestCell = NO_INTEREST_CELL;
+    ChangeInterest(standing_cell, -1);
+}
+
+void Map::ChangeInterest(CellPair const& standing_cell, int32 diff)
+{
+    // the overloaded operators handle range checking
+    // so ther's no need for range checking inside the loop
+    CellPair begin_cell(standing_cell), end_cell(standing_cell);
+    begin_cell << 1; begin_cell -= 1;                       // upper left
+    end_cell >> 1; end_cell += 1;                           // lower right
+
+    for (uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; ++x)
+    {
+        for (uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (diff > 0)
+                ++m_cellInterest[cell_id];
+            else
+            {
+                CellInterestMap::iterator itr = m_cellInterest.find(cell_id);
+                if (itr != m_cellInterest.end() && --itr->second == 0)
+                    m_cellInterest.erase(itr);
+            }
+        }
+    }
+}
+
 void Map::AddUnitToNotify(Unit* u)
 {
     if (u->m_IsInNotifyList)
@@ -674,57 +851,33 @@ void Map::AddUnitToNotify(Unit* u)
 
 void Map::Update(const uint32 &t_diff)
 {
+    RandomGeneratorScope randomScope(GetRandomSeed() ? &mtRand : NULL);
+
     i_lock = false;
 
-    resetMarkedCells();
+    if (!i_gridsToPreload.empty())
+        ProcessGridPreloadQueue();
 
-    Neo::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<Neo::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<Neo::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+    // handle the map local packets of the players here, in the map's thread
+    if (sWorld.getConfig(CONFIG_MAP_PACKETS))
+    {
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+                plr->GetSession()->ProcessMapPackets();
+        }
+    }
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* plr = m_mapRefIter->getSource();
-
-        if (!plr->IsInWorld())
-            continue;
-
-        CellPair standing_cell(Neo::ComputeCellPair(plr->GetPositionX(), plr->GetPositionY()));
-
-        // Check for correctness of standing_cell, it also avoids problems with update_cell
-        if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
-            continue;
-
-        // the overloaded operators handle range checking
-        // so ther's no need for range checking inside the loop
-        CellPair begin_cell(standing_cell), end_cell(standing_cell);
-        begin_cell << 1; begin_cell -= 1;               // upper left
-        end_cell >> 1; end_cell += 1;                   // lower right
-
-        for (uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; ++x)
-        {
-            for (uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
-            {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                {
-                    markCell(cell_id);
-                    CellPair pair(x,y);
-                    Cell cell(pair);
-                    cell.data.Part.reserved = CENTER_DISTRICT;
-                    //cell.SetNoCreate();
-                    CellLock<NullGuard> cell_lock(cell, pair);
-                    cell_lock->Visit(cell_lock, grid_object_update,  *this);
-                    cell_lock->Visit(cell_lock, world_object_update, *this);
-                }
-            }
-        }
+        if (plr->IsInWorld())
+            UpdateInterest(plr);
+        else
+            RemoveInterest(plr);
     }
 
     // non-player active objects
@@ -740,7 +893,10 @@ void Map::Update(const uint32 &t_diff)
             ++m_activeNonPlayersIter;
 
             if (!obj->IsInWorld())
+            {
+                RemoveInterest(obj);
                 continue;
+            }
 
             // Update bindsight players
             /*if (obj->isType(TYPEMASK_UNIT))
@@ -769,47 +925,44 @@ void Map::Update(const uint32 &t_diff)
                     }
             }
 
-            CellPair standing_cell(Neo::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
+            UpdateInterest(obj);
+        }
+    }
 
-            // Check for correctness of standing_cell, it also avoids problems with update_cell
-            if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
-                continue;
+    Neo::ObjectUpdater updater(t_diff);
+    // for creature
+    TypeContainerVisitor<Neo::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<Neo::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-            // the overloaded operators handle range checking
-            // so ther's no need for range checking inside the loop
-            CellPair begin_cell(standing_cell), end_cell(standing_cell);
-            begin_cell << 1; begin_cell -= 1;               // upper left
-            end_cell >> 1; end_cell += 1;                   // lower right
+    // every cell some player or active object is interested in, once
+    // updated objects may change the interest, so work on a copy
+    i_cellsUpdating.clear();
+    for (CellInterestMap::const_iterator itr = m_cellInterest.begin(); itr != m_cellInterest.end(); ++itr)
+        i_cellsUpdating.push_back(itr->first);
 
-            for (uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; ++x)
-            {
-                for (uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x,y);
-                        Cell cell(pair);
-                        cell.data.Part.reserved = CENTER_DISTRICT;
-                        //cell.SetNoCreate();
-                        CellLock<NullGuard> cell_lock(cell, pair);
-                        cell_lock->Visit(cell_lock, grid_object_update,  *this);
-                        cell_lock->Visit(cell_lock, world_object_update, *this);
-                    }
-                }
-            }
-        }
+    for (std::vector<uint32>::const_iterator itr = i_cellsUpdating.begin(); itr != i_cellsUpdating.end(); ++itr)
+    {
+        CellPair pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.data.Part.reserved = CENTER_DISTRICT;
+        //cell.SetNoCreate();
+        CellLock<NullGuard> cell_lock(cell, pair);
+        cell_lock->Visit(cell_lock, grid_object_update,  *this);
+        cell_lock->Visit(cell_lock, world_object_update, *this);
     }
 
+    ScriptsProcess();
+    ProcessRespawns();
+
     i_lock = true;
 
     MoveAllCreaturesInMoveList();
     RelocationNotify();
     RemoveAllObjectsInRemoveList();
 
+    SendObjectUpdates();
+
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (IsBattleGroundOrArena())
@@ -825,6 +978,148 @@ void Map::Update(const uint32 &t_diff)
     }
 }
 
+// m_objectUpdated is only changed under the lock, so an object written by another thread
+// while SendObjectUpdates() works is queued exactly once more
+void Map::AddUpdateObject(WorldObject* obj)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(i_objectsToClientUpdateLock);
+    if (obj->m_objectUpdated)
+        return;
+
+    obj->m_objectUpdated = true;
+    obj->m_updateQueueSlot = i_objectsToClientUpdate.size();
+    i_objectsToClientUpdate.push_back(obj);
+}
+
+void Map::RemoveUpdateObject(WorldObject* obj)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(i_objectsToClientUpdateLock);
+    obj->m_objectUpdated = false;
+
+    uint32 slot = obj->m_updateQueueSlot;
+    if (slot >= i_objectsToClientUpdate.size() || i_objectsToClientUpdate[slot] != obj)
+        return;
+
+    // fill the gap with the last one
+    WorldObject* last = i_objectsToClientUpdate.back();
+    i_objectsToClientUpdate[slot] = last;
+    last->m_updateQueueSlot = slot;
+    i_objectsToClientUpdate.pop_back();
+}
+
+void Map::SendObjectUpdates()
+{
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(i_objectsToClientUpdateLock);
+        if (i_objectsToClientUpdate.empty())
+            return;
+        i_objectsUpdating.swap(i_objectsToClientUpdate);
+
+        // from here on a field change queues the object again for the next send
+        for (size_t i = 0; i < i_objectsUpdating.size(); ++i)
+            i_objectsUpdating[i]->m_objectUpdated = false;
+    }
+
+    UpdateDataMapType update_players;
+    for (size_t i = 0; i < i_objectsUpdating.size(); ++i)
+    {
+        WorldObject* obj = i_objectsUpdating[i];
+        if (!obj->IsInWorld())
+            continue;
+
+        // clear only the fields known to be sent, one changed during the build stays for the next send
+        i_sentValues = obj->m_changedValues;
+        ObjectAccessor::_buildUpdateObject(obj, update_players);
+        obj->m_changedValues.UnsetBits(i_sentValues);
+    }
+    i_objectsUpdating.clear();
+
+    WorldPacket packet;
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();
+    }
+}
+
+void Map::ScheduleRespawn(Creature* creature)
+{
+    // spirit services stay dead, summons and pets are removed instead of respawning
+    if (creature->isSpiritService() || creature->isPet() || creature->isTotem() || creature->isTemporarySummon())
+        return;
+
+    time_t when = creature->GetRespawnTime();
+    // an earlier wake-up is already queued, it reschedules when it finds the creature still dead
+    if (creature->m_respawnScheduled && creature->m_respawnScheduled <= when)
+        return;
+
+    creature->m_respawnScheduled = when;
+    m_respawnSchedule.insert(RespawnSchedule::value_type(when, creature->GetGUID()));
+}
+
+void Map::ProcessRespawns()
+{
+    time_t now = time(NULL);
+    while (!m_respawnSchedule.empty() && m_respawnSchedule.begin()->first <= now)
+    {
+        time_t when = m_respawnSchedule.begin()->first;
+        uint64 guid = m_respawnSchedule.begin()->second;
+        m_respawnSchedule.erase(m_respawnSchedule.begin());
+
+        // left the map or got a new wake-up meanwhile
+        Creature* creature = GetCreatureInMap(guid);
+        if (!creature || creature->m_respawnScheduled != when)
+            continue;
+
+        creature->m_respawnScheduled = 0;
+        if (creature->getDeathState() != DEAD)
+            continue;
+
+        creature->UpdateRespawn();
+
+        // not due yet or delayed by a linked respawn
+        if (creature->getDeathState() == DEAD)
+            ScheduleRespawn(creature);
+    }
+}
+
+void Map::ScriptActionSchedule(time_t when, ScriptAction const& sa)
+{
+    // other threads may queue for this map while it is updated
+    ACE_Guard<ACE_Thread_Mutex> guard(m_scriptScheduleLock);
+    m_scriptSchedule.insert(ScriptSchedule::value_type(when, sa));
+}
+
+void Map::ScriptsProcess()
+{
+    std::vector<ScriptAction> steps;
+
+    // executed steps may queue new ones for now, run them in the same pass
+    for (;;)
+    {
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_scriptScheduleLock);
+            if (m_scriptSchedule.empty())
+                return;
+
+            ScriptSchedule::iterator end = m_scriptSchedule.upper_bound(sWorld.GetGameTime());
+            for (ScriptSchedule::iterator itr = m_scriptSchedule.begin(); itr != end; ++itr)
+                steps.push_back(itr->second);
+            m_scriptSchedule.erase(m_scriptSchedule.begin(), end);
+        }
+
+        if (steps.empty())
+            return;
+
+        for (std::vector<ScriptAction>::const_iterator itr = steps.begin(); itr != steps.end(); ++itr)
+            sWorld.ScriptActionExecute(*itr, this);
+
+        sWorld.ScriptActionDone(long(steps.size()));
+        steps.clear();
+    }
+}
+
 void Map::Remove(Player *player, bool remove)
 {
     // this may be called during Map::Update
@@ -835,6 +1130,7 @@ void Map::Remove(Player *player, bool remove)
     if (m_mapRefIter == player->GetMapRef())
         m_mapRefIter = m_mapRefIter->nocheck_prev();
     player->GetMapRef().unlink();
+    RemoveInterest(player);
     CellPair p = Neo::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -930,10 +1226,16 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
     new_cell |= old_cell;
     bool same_cell = (new_cell == old_cell);
 
+    float old_x = player->GetPositionX();
+    float old_y = player->GetPositionY();
+
     player->Relocate(x, y, z, orientation);
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
     {
+        if (sWorld.getConfig(CONFIG_GRID_PRELOAD_DISTANCE))
+            QueueGridPreload(x, y, x - old_x, y - old_y);
+
         DEBUG_LOG("Player %s relocation grid[%u,%u]cell[%u,%u]->grid[%u,%u]cell[%u,%u]", player->GetName(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 
         // update player position for group at taxi flight
@@ -959,7 +1261,7 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
 }
 
 void
-Map::CreatureRelocation(Creature *creature, float x, float y, float z, float ang)
+Map::CreatureRelocation(Creature *creature, float x, float y, float z, float ang, bool pathStep)
 {
     assert(CheckGridIntegrity(creature,false));
 
@@ -981,7 +1283,10 @@ Map::CreatureRelocation(Creature *creature, float x, float y, float z, float ang
     else
     {
         creature->Relocate(x, y, z, ang);
-        AddUnitToNotify(creature);
+
+        // steps along a path inside the cell only notify once the creature got far enough from the last notify
+        if (!pathStep || (x - creature->oldX) * (x - creature->oldX) + (y - creature->oldY) * (y - creature->oldY) >= CREATURE_PATH_NOTIFY_DIST * CREATURE_PATH_NOTIFY_DIST)
+            AddUnitToNotify(creature);
     }
     assert(CheckGridIntegrity(creature,true));
 }
@@ -1194,6 +1499,8 @@ void Map::UnloadAll()
 {
     // clear all delayed moves, useless anyway do this moves before map unload.
     i_creaturesToMove.clear();
+    i_gridsToPreload.clear();
+    i_gridPreloadQueued.reset();
 
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
     {
@@ -2470,6 +2777,8 @@ bool InstanceMap::Add(Player *player)
 
 void InstanceMap::Update(const uint32& t_diff)
 {
+    RandomGeneratorScope randomScope(GetRandomSeed() ? &mtRand : NULL);
+
     Map::Update(t_diff);
 
     if (i_data)
@@ -2489,16 +2798,38 @@ void InstanceMap::Remove(Player *player, bool remove)
 
 Creature * Map::GetCreatureInMap(uint64 guid)
 {
-    Creature * obj = HashMapHolder<Creature>::Find(guid);
-    if (obj && obj->GetInstanceId() != GetInstanceId()) obj = NULL;
-    return obj;
+    UNORDERED_MAP<uint64, Creature*>::const_iterator itr = m_creaturesByGuid.find(guid);
+    return itr != m_creaturesByGuid.end() ? itr->second : NULL;
 }
 
 GameObject * Map::GetGameObjectInMap(uint64 guid)
 {
-    GameObject * obj = HashMapHolder<GameObject>::Find(guid);
-    if (obj && obj->GetInstanceId() != GetInstanceId()) obj = NULL;
-    return obj;
+    UNORDERED_MAP<uint64, GameObject*>::const_iterator itr = m_gameObjectsByGuid.find(guid);
+    return itr != m_gameObjectsByGuid.end() ? itr->second : NULL;
+}
+
+void Map::InsertObjectGuid(Creature* obj)
+{
+    m_creaturesByGuid[obj->GetGUID()] = obj;
+}
+
+void Map::InsertObjectGuid(GameObject* obj)
+{
+    m_gameObjectsByGuid[obj->GetGUID()] = obj;
+}
+
+void Map::RemoveObjectGuid(Creature* obj)
+{
+    UNORDERED_MAP<uint64, Creature*>::iterator itr = m_creaturesByGuid.find(obj->GetGUID());
+    if (itr != m_creaturesByGuid.end() && itr->second == obj)
+        m_creaturesByGuid.erase(itr);
+}
+
+void Map::RemoveObjectGuid(GameObject* obj)
+{
+    UNORDERED_MAP<uint64, GameObject*>::iterator itr = m_gameObjectsByGuid.find(obj->GetGUID());
+    if (itr != m_gameObjectsByGuid.end() && itr->second == obj)
+        m_gameObjectsByGuid.erase(itr);
 }
 
 void InstanceMap::CreateInstanceData(bool load)
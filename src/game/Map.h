@@ -32,7 +32,9 @@
 #include "SharedDefines.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
-#include "mersennetwister/MersenneTwister.h"
+#include "Util.h"
+#include "UpdateMask.h"
+#include "ScriptAction.h"
 
 //#include "Unit.h"
 
@@ -248,6 +250,7 @@ typedef UNORDERED_MAP<Creature*, CreatureMover> CreatureMoveList;
 #define INVALID_HEIGHT       -100000.0f                     // for check, must be equal to VMAP_INVALID_HEIGHT, real value for unknown height is VMAP_INVALID_HEIGHT_VALUE
 #define DEFAULT_HEIGHT_SEARCH     10.0f                     // default search distance to find height at nearby locations
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
+#define CREATURE_PATH_NOTIFY_DIST 3.0f                      // distance a creature walks along its path before the relocation notifiers run again
 
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
 
@@ -279,8 +282,12 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         void MessageDistBroadcast(Player *, WorldPacket *, float dist, bool to_self, bool to_possessor, bool own_team_only = false);
         void MessageDistBroadcast(WorldObject *, WorldPacket *, float dist, bool to_possessor);
 
+        // called by the map thread and by player sessions, any thread may queue
+        void AddUpdateObject(WorldObject* obj);
+        void RemoveUpdateObject(WorldObject* obj);
+
         void PlayerRelocation(Player *, float x, float y, float z, float angl);
-        void CreatureRelocation(Creature *creature, float x, float y, float, float);
+        void CreatureRelocation(Creature *creature, float x, float y, float, float, bool pathStep = false);
 
         template<class LOCK_TYPE, class T, class CONTAINER> void Visit(const CellLock<LOCK_TYPE> &cell, TypeContainerVisitor<T, CONTAINER> &visitor);
 
@@ -293,9 +300,15 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         bool GetUnloadLock(const GridPair &p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void LoadGrid(float x, float y);
+        void QueueGridPreload(float x, float y, float dx, float dy);
         bool UnloadGrid(const uint32 &x, const uint32 &y, bool pForce);
         virtual void UnloadAll();
 
+        // DB script actions of objects on this map, executed during its update
+        void ScriptActionSchedule(time_t when, ScriptAction const& sa);
+        void ScriptsProcess();
+        void ProcessRespawns();
+
         void ResetGridExpiry(NGridType &grid, float factor = 1) const
         {
             grid.ResetTimeTracker((time_t)((float)i_gridExpiry*factor));
@@ -370,12 +383,19 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
         Creature* GetCreatureInMap(uint64 guid);
         GameObject* GetGameObjectInMap(uint64 guid);
 
+        // map local guid lookup without a lock. Filled from Creature/GameObject::AddToWorld and
+        // RemoveFromWorld, which run in this map's update thread or on the world thread: GM spawn
+        // commands (WorldSession::Update), battleground and outdoor pvp spawns, game events and
+        // ScriptsProcess. Those world thread callers are only safe because they run before or
+        // after the parallel map loop in MapManager::Update, never during it.
+        void InsertObjectGuid(Creature* obj);
+        void InsertObjectGuid(GameObject* obj);
+        void RemoveObjectGuid(Creature* obj);
+        void RemoveObjectGuid(GameObject* obj);
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(uint32 x, uint32 y) const;
@@ -383,6 +403,9 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         void AddUnitToNotify(Unit* unit);
         void RelocationNotify();
 
+        // dead creatures of the map are woken up from here at their respawn time instead of checking it every update
+        void ScheduleRespawn(Creature* creature);
+
         void SendToPlayers(WorldPacket const* data) const;
 
         typedef MapRefManager PlayerList;
@@ -404,32 +427,34 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         template<class NOTIFIER> void VisitAll(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitWorld(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitGrid(const float &x, const float &y, float radius, NOTIFIER &notifier);
+        // world objects in the cells of a walk around (x, y) that a walk around (skip_x, skip_y) doesn't reach
+        template<class NOTIFIER> void VisitWorldExcept(const float &x, const float &y, const float &skip_x, const float &skip_y, float radius, NOTIFIER &notifier);
         CreatureGroupHolderType CreatureGroupHolder;
-        MTRand mtRand;
+        RandomGenerator mtRand;
 
         int32 irand(int32 min, int32 max)
         {
-          return int32 (mtRand.randInt(max - min)) + min;
+          return int32 (mtRand.NextInt(max - min)) + min;
         }
 
         uint32 urand(uint32 min, uint32 max)
         {
-          return mtRand.randInt(max - min) + min;
+          return mtRand.NextInt(max - min) + min;
         }
 
         int32 rand32()
         {
-          return mtRand.randInt();
+          return mtRand.Next();
         }
 
         double rand_norm(void)
         {
-          return mtRand.randExc();
+          return mtRand.NextDouble();
         }
 
         double rand_chance(void)
         {
-          return mtRand.randExc(100.0);
+          return mtRand.NextDouble() * 100.0;
         }
 
     private:
@@ -453,6 +478,7 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         bool loaded(const GridPair &) const;
         void EnsureGridLoaded(const Cell&, Player* player = NULL);
         void  EnsureGridCreated(const GridPair &);
+        void ProcessGridPreloadQueue();
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -470,6 +496,15 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
 
         void UpdateActiveCells(const float &x, const float &y, const uint32 &t_diff);
+        void SendObjectUpdates();
+
+        // interest management, the cells around players and active objects are updated
+        void UpdateInterest(WorldObject* obj);
+        void RemoveInterest(WorldObject* obj);
+        void ChangeInterest(CellPair const& standing_cell, int32 diff);
+
+        // cell range the Visit* functions walk for the radius around (x, y), false if off the map
+        static bool GetVisitCellRange(float x, float y, float radius, CellPair &begin_cell, CellPair &end_cell);
     protected:
         void SetUnloadReferenceLock(const GridPair &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
 
@@ -493,7 +528,6 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap *GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
         time_t i_gridExpiry;
 
@@ -501,6 +535,24 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
         std::vector<uint64> i_unitsToNotifyBacklog;
         std::vector<Unit*> i_unitsToNotify;
         std::set<WorldObject *> i_objectsToRemove;
+        std::deque<GridPair> i_gridsToPreload;
+        std::bitset<MAX_NUMBER_OF_GRIDS*MAX_NUMBER_OF_GRIDS> i_gridPreloadQueued;
+        ScriptSchedule m_scriptSchedule;
+        ACE_Thread_Mutex m_scriptScheduleLock;
+
+        typedef std::multimap<time_t, uint64> RespawnSchedule;
+        RespawnSchedule m_respawnSchedule;
+        std::vector<WorldObject*> i_objectsToClientUpdate;  // objects with changed fields, WorldObject::m_updateQueueSlot indexes this
+        std::vector<WorldObject*> i_objectsUpdating;        // the ones SendObjectUpdates() works on
+        ACE_Thread_Mutex i_objectsToClientUpdateLock;
+        UpdateMask i_sentValues;                            // changed fields of the object SendObjectUpdates() builds
+
+        typedef UNORDERED_MAP<uint32, uint32> CellInterestMap;
+        CellInterestMap m_cellInterest;                     // cell id -> number of players and active objects in range
+        std::vector<uint32> i_cellsUpdating;
+
+        UNORDERED_MAP<uint64, Creature*> m_creaturesByGuid;
+        UNORDERED_MAP<uint64, GameObject*> m_gameObjectsByGuid;
         std::map<WorldObject*, bool> i_objectsToSwitch;
 
         // Type specific code for add/remove to/from grid
@@ -537,6 +589,8 @@ class NEO_DLL_SPEC Map : public GridRefManager<NGridType>, public Neo::ObjectLev
             }
             else
                 m_activeNonPlayers.erase(obj);
+
+            RemoveInterest(obj);
         }
 };
 
@@ -661,5 +715,33 @@ Map::VisitGrid(const float &x, const float &y, float radius, NOTIFIER &notifier)
     TypeContainerVisitor<NOTIFIER, GridTypeMapContainer >  grid_object_notifier(notifier);
     cell_lock->Visit(cell_lock, grid_object_notifier, *this, radius, x_off, y_off);
 }
+
+template<class NOTIFIER>
+inline void
+Map::VisitWorldExcept(const float &x, const float &y, const float &skip_x, const float &skip_y, float radius, NOTIFIER &notifier)
+{
+    CellPair begin_cell, end_cell;
+    if (!GetVisitCellRange(x, y, radius, begin_cell, end_cell))
+        return;
+
+    CellPair skip_begin, skip_end;
+    bool skip = GetVisitCellRange(skip_x, skip_y, radius, skip_begin, skip_end);
+
+    TypeContainerVisitor<NOTIFIER, WorldTypeMapContainer> world_object_notifier(notifier);
+    for (uint32 cx = begin_cell.x_coord; cx <= end_cell.x_coord; ++cx)
+    {
+        for (uint32 cy = begin_cell.y_coord; cy <= end_cell.y_coord; ++cy)
+        {
+            if (skip && cx >= skip_begin.x_coord && cx <= skip_end.x_coord && cy >= skip_begin.y_coord && cy <= skip_end.y_coord)
+                continue;
+
+            CellPair cell_pair(cx, cy);
+            Cell cell(cell_pair);
+            cell.SetNoCreate();
+            CellLock<GridReadGuard> cell_lock(cell, cell_pair);
+            Visit(cell_lock, world_object_notifier);
+        }
+    }
+}
 #endif
 
@@ -40,13 +40,16 @@ INSTANTIATE_CLASS_MUTEX(MapManager, ACE_Thread_Mutex);
 
 extern GridState* si_GridStates[];                          // debugging code, should be deleted some day
 
-MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN))
+MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN)),
+    m_gridMapLoader(NULL), m_gridMapLoaderThread(NULL)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE));
 }
 
 MapManager::~MapManager()
 {
+    HaltGridMapLoader();
+
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -71,6 +74,21 @@ MapManager::Initialize()
     }
 
     InitMaxInstanceId();
+
+    m_gridMapLoader = new GridMapLoader();                  // will deleted at m_gridMapLoaderThread delete
+    m_gridMapLoaderThread = new ACE_Based::Thread(m_gridMapLoader);
+}
+
+void MapManager::HaltGridMapLoader()
+{
+    if (!m_gridMapLoader || !m_gridMapLoaderThread)
+        return;
+
+    m_gridMapLoader->Stop();
+    m_gridMapLoaderThread->wait();
+    delete m_gridMapLoaderThread;                           // this also deletes m_gridMapLoader
+    m_gridMapLoaderThread = NULL;
+    m_gridMapLoader = NULL;
 }
 
 // debugging code, should be deleted some day
@@ -27,6 +27,7 @@
 #include "Common.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "GridMapLoader.h"
 
 class Transport;
 
@@ -78,6 +79,10 @@ class NEO_DLL_DECL MapManager : public Neo::Singleton<MapManager, Neo::ClassLeve
         //void LoadGrid(int mapid, float x, float y, const WorldObject* obj, bool no_unload = false);
         void UnloadAll();
 
+        // terrain reader of the grid preloader, NULL before Initialize and after HaltGridMapLoader
+        GridMapLoader* GetGridMapLoader() { return m_gridMapLoader; }
+        void HaltGridMapLoader();
+
         static bool ExistMapAndVMap(uint32 mapid, float x, float y);
         static bool IsValidMAP(uint32 mapid);
 
@@ -140,6 +145,9 @@ class NEO_DLL_DECL MapManager : public Neo::Singleton<MapManager, Neo::ClassLeve
         IntervalTimer i_timer;
 
         uint32 i_MaxInstanceId;
+
+        GridMapLoader* m_gridMapLoader;
+        ACE_Based::Thread* m_gridMapLoaderThread;
 };
 #endif
 
@@ -440,9 +440,10 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data )
                 return;
             }
             // elevators also cause the client to send MOVEMENTFLAG_ONTRANSPORT - just unmount if the guid can be found in the transport list
+            // only transports of the player's own map: this runs in the map's update thread
             for (MapManager::TransportSet::iterator iter = MapManager::Instance().m_Transports.begin(); iter != MapManager::Instance().m_Transports.end(); ++iter)
             {
-                if ((*iter)->GetGUID() == movementInfo.t_guid)
+                if ((*iter)->GetGUID() == movementInfo.t_guid && (*iter)->GetMapId() == GetPlayer()->GetMapId())
                 {
                     // unmount before boarding
                     GetPlayer()->RemoveSpellsCausingAura(SPELL_AURA_MOUNTED);
@@ -637,7 +638,7 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data )
         GetPlayer()->RemoveSpellsCausingAura(SPELL_AURA_FEIGN_DEATH);
 
     if (movementInfo.z < -500.0f)
-        GetPlayer()->HandleFallUnderMap();
+        GetPlayer()->ScheduleFallUnderMap();
 }
 
 void WorldSession::HandlePossessedMovement(WorldPacket& recv_data, MovementInfo& movementInfo, uint32& MovementFlags)
@@ -690,7 +691,7 @@ void WorldSession::HandlePossessedMovement(WorldPacket& recv_data, MovementInfo&
         if (movementInfo.z < -500.0f)
         {
             GetPlayer()->Uncharm();
-            plr->HandleFallUnderMap();
+            plr->ScheduleFallUnderMap();
         }
     }
     else // Possessed unit is a creature
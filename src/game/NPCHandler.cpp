@@ -493,6 +493,12 @@ void WorldSession::SendStablePet(uint64 guid )
 {
     sLog.outDebug("WORLD: Recv MSG_LIST_STABLED_PETS Send.");
 
+    //                                                                              0      1     2   3      4      5        6
+    AsyncPQuery(&WorldSession::SendStablePetContinuation, guid, "SELECT owner, slot, id, entry, level, loyalty, name FROM character_pet WHERE owner = '%u' AND slot > 0 AND slot < 3",_player->GetGUIDLow());
+}
+
+void WorldSession::SendStablePetContinuation(QueryResult_AutoPtr result, uint64 guid)
+{
     WorldPacket data(MSG_LIST_STABLED_PETS, 200);           // guess size
     data << uint64 (guid);
 
@@ -515,9 +521,6 @@ void WorldSession::SendStablePet(uint64 guid )
         ++num;
     }
 
-    //                                                            0      1     2   3      4      5        6
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT owner, slot, id, entry, level, loyalty, name FROM character_pet WHERE owner = '%u' AND slot > 0 AND slot < 3",_player->GetGUIDLow());
-
     if (result)
     {
         do
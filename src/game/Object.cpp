@@ -46,6 +46,8 @@
 
 #include "TemporarySummon.h"
 
+#include <ace/TSS_T.h>
+
 uint32 GuidHigh2TypeId(uint32 guid_hi)
 {
     switch(guid_hi)
@@ -63,13 +65,23 @@ uint32 GuidHigh2TypeId(uint32 guid_hi)
     return 10;                                              // unknown
 }
 
+// Buffers reused by the update block builders, map threads build blocks concurrently
+struct UpdateBlockScratch
+{
+    UpdateBlockScratch() : buf(500) {}
+
+    UpdateMask mask;
+    ByteBuffer buf;
+};
+
+static ACE_TSS<UpdateBlockScratch> updateBlockScratch;
+
 Object::Object() : m_PackGUID(sizeof(uint64)+1)
 {
     m_objectTypeId      = TYPEID_OBJECT;
     m_objectType        = TYPEMASK_OBJECT;
 
     m_uint32Values      = 0;
-    m_uint32Values_mirror = 0;
     m_valuesCount       = 0;
 
     m_inWorld           = false;
@@ -96,9 +108,7 @@ Object::~Object()
 
         //DEBUG_LOG("Object desctr 1 check (%p)",(void*)this);
         delete [] m_uint32Values;
-        delete [] m_uint32Values_mirror;
         m_uint32Values = NULL;
-        m_uint32Values_mirror = NULL;
         //DEBUG_LOG("Object desctr 2 check (%p)",(void*)this);
     }
 }
@@ -108,8 +118,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount*sizeof(uint32));
 
-    m_uint32Values_mirror = new uint32[ m_valuesCount ];
-    memset(m_uint32Values_mirror, 0, m_valuesCount*sizeof(uint32));
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -182,7 +191,10 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData *data, Player *target) c
 
     //sLog.outDebug("BuildCreateUpdate: update-type: %u, object-type: %u got flags: %X, flags2: %X", updatetype, m_objectTypeId, flags, flags2);
 
-    ByteBuffer buf(500);
+    UpdateBlockScratch* scratch = updateBlockScratch;
+    ByteBuffer& buf = scratch->buf;
+    buf.clear();
+
     buf << (uint8)updatetype;
     //buf.append(GetPackGUID());    //client crashes when using this
     buf << (uint8)0xFF << GetGUID();
@@ -190,7 +202,7 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData *data, Player *target) c
 
     _BuildMovementUpdate(&buf, flags, flags2);
 
-    UpdateMask updateMask;
+    UpdateMask& updateMask = scratch->mask;
     updateMask.SetCount(m_valuesCount);
     _SetCreateBits(&updateMask, target);
     _BuildValuesUpdate(updatetype, &buf, &updateMask, target);
@@ -221,20 +233,55 @@ void Object::SendUpdateToPlayer(Player* player)
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target) const
 {
-    ByteBuffer buf(500);
+    ByteBuffer& buf = updateBlockScratch->buf;
+    BuildValuesUpdateBlock(&buf, target);
+    data->AddUpdateBlock(buf);
+}
+
+void Object::BuildValuesUpdateBlock(ByteBuffer *buf, Player *target) const
+{
+    buf->clear();
 
-    buf << (uint8) UPDATETYPE_VALUES;
+    *buf << (uint8) UPDATETYPE_VALUES;
     //buf.append(GetPackGUID());    //client crashes when using this. but not have crash in debug mode
-    buf << (uint8)0xFF;
-    buf << GetGUID();
+    *buf << (uint8)0xFF;
+    *buf << GetGUID();
 
-    UpdateMask updateMask;
+    UpdateMask& updateMask = updateBlockScratch->mask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
-    _BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+    _BuildValuesUpdate(UPDATETYPE_VALUES, buf, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+// Must match the per target cases of _SetUpdateBits and _BuildValuesUpdate for the changed fields
+UpdateViewerClass Object::GetUpdateViewerClass(Player *target) const
+{
+    // gamemaster views and gameobject quest states are built per viewer
+    if (target->isGameMaster() || isType(TYPEMASK_GAMEOBJECT))
+        return UPDATE_VIEWER_UNIQUE;
+
+    if (target == this)
+        return UPDATE_VIEWER_SELF;
+
+    switch (GetTypeId())
+    {
+        case TYPEID_UNIT:
+            // lootable state depends on the viewer
+            if (m_changedValues.GetBit(UNIT_DYNAMIC_FLAGS))
+                return UPDATE_VIEWER_UNIQUE;
+            break;
+        case TYPEID_PLAYER:
+            // group members see each other friendly
+            if (m_changedValues.GetBit(UNIT_FIELD_BYTES_2) || m_changedValues.GetBit(UNIT_FIELD_FACTIONTEMPLATE))
+            {
+                if (target->IsInSameGroupWith(ToPlayer()) || target->IsInSameRaidWith(ToPlayer()))
+                    return m_changedValues.GetBit(UNIT_FIELD_FACTIONTEMPLATE) ? UPDATE_VIEWER_UNIQUE : UPDATE_VIEWER_GROUP;
+            }
+            break;
+    }
+
+    return UPDATE_VIEWER_PUBLIC;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData * data) const
@@ -564,165 +611,167 @@ void Object::_BuildValuesUpdate(uint8 updatetype, ByteBuffer * data, UpdateMask
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                               // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++ )
+        for (uint16 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index ) )
+            // remove custom flag before send
+            if (index == UNIT_NPC_FLAGS )
+                *data << uint32(m_uint32Values[ index ] & ~(UNIT_NPC_FLAG_GUARD + UNIT_NPC_FLAG_OUTDOORPVP));
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
             {
-                // remove custom flag before send
-                if (index == UNIT_NPC_FLAGS )
-                    *data << uint32(m_uint32Values[ index ] & ~(UNIT_NPC_FLAG_GUARD + UNIT_NPC_FLAG_OUTDOORPVP));
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
-                }
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if (index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
-                    index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
-                {
-                    *data << uint32(m_floatValues[ index ]);
-                }
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-                else if (index == UNIT_FIELD_DISPLAYID && GetTypeId() == TYPEID_UNIT)
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
+            }
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if (index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
+                index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
+            {
+                *data << uint32(m_floatValues[ index ]);
+            }
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
+            else if (index == UNIT_FIELD_DISPLAYID && GetTypeId() == TYPEID_UNIT)
+            {
+                const CreatureInfo* cinfo = ToCreature()->GetCreatureInfo();
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
                 {
-                    const CreatureInfo* cinfo = ToCreature()->GetCreatureInfo();
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                    if (target->isGameMaster())
                     {
-                        if (target->isGameMaster())
-                        {
-                            if (cinfo->Modelid_A2)
-                                *data << cinfo->Modelid_A1;
-                            else
-                                *data << 17519; // world invisible trigger's model
-                        }
+                        if (cinfo->Modelid_A2)
+                            *data << cinfo->Modelid_A1;
                         else
-                        {
-                            if (cinfo->Modelid_A2)
-                                *data << cinfo->Modelid_A2;
-                            else
-                                *data << 11686; // world invisible trigger's model
-                        }
+                            *data << 17519; // world invisible trigger's model
                     }
                     else
-                        *data << m_uint32Values[ index ];
+                    {
+                        if (cinfo->Modelid_A2)
+                            *data << cinfo->Modelid_A2;
+                        else
+                            *data << 11686; // world invisible trigger's model
+                    }
                 }
-                // hide lootable animation for unallowed players
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+                else
+                    *data << m_uint32Values[ index ];
+            }
+            // hide lootable animation for unallowed players
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                if (!target->isAllowedToLoot(ToCreature()))
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
+                else
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
+            }
+            // FG: pretend that OTHER players in own group are friendly ("blue")
+            else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
+            {
+            bool ch = false;
+                if (target->GetTypeId() == TYPEID_PLAYER && GetTypeId() == TYPEID_PLAYER && target != this)
                 {
-                    if (!target->isAllowedToLoot(ToCreature()))
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
-                    else
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
-                }
-                // FG: pretend that OTHER players in own group are friendly ("blue")
-                else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
+                if (target->IsInSameGroupWith(ToPlayer()) || target->IsInSameRaidWith(ToPlayer()))
                 {
-                bool ch = false;
-                    if (target->GetTypeId() == TYPEID_PLAYER && GetTypeId() == TYPEID_PLAYER && target != this)
+                    if (index == UNIT_FIELD_BYTES_2)
                     {
-                    if (target->IsInSameGroupWith(ToPlayer()) || target->IsInSameRaidWith(ToPlayer()))
+                        DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (flag)", target->GetName(), ToPlayer()->GetName());
+                        *data << (m_uint32Values[ index ] & ((UNIT_BYTE2_FLAG_SANCTUARY | UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5) << 8)); // this flag is at uint8 offset 1 !!
+
+                        ch = true;
+                    }
+                    else if (index == UNIT_FIELD_FACTIONTEMPLATE)
                     {
-                        if (index == UNIT_FIELD_BYTES_2)
+                        FactionTemplateEntry const *ft1, *ft2;
+                        ft1 = ToPlayer()->getFactionTemplateEntry();
+                        ft2 = target->ToPlayer()->getFactionTemplateEntry();
+                        if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
                         {
-                            DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (flag)", target->GetName(), ToPlayer()->GetName());
-                            *data << (m_uint32Values[ index ] & ((UNIT_BYTE2_FLAG_SANCTUARY | UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5) << 8)); // this flag is at uint8 offset 1 !!
-
+                            uint32 faction = target->ToPlayer()->getFaction(); // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                            DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (faction %u)", target->GetName(), ToPlayer()->GetName(), faction);
+                            *data << uint32(faction);
                             ch = true;
                         }
-                        else if (index == UNIT_FIELD_FACTIONTEMPLATE)
-                        {
-                            FactionTemplateEntry const *ft1, *ft2;
-                            ft1 = ToPlayer()->getFactionTemplateEntry();
-                            ft2 = target->ToPlayer()->getFactionTemplateEntry();
-                            if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
-                            {
-                                uint32 faction = target->ToPlayer()->getFaction(); // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                                DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (faction %u)", target->GetName(), ToPlayer()->GetName(), faction);
-                                *data << uint32(faction);
-                                ch = true;
-                            }
-                        }
-                    }
                     }
-                    if (!ch)
-                        *data << m_uint32Values[ index ];
                 }
-                else
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[ index ];
                 }
+                if (!ch)
+                    *data << m_uint32Values[ index ];
+            }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[ index ];
             }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                    // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++ )
+        for (uint16 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index ) )
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS )
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS )
+                if (IsActivateToQuest )
                 {
-                    if (IsActivateToQuest )
+                    switch(((GameObject*)this)->GetGoType())
                     {
-                        switch(((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_CHEST:
-                                *data << uint32(9);         // enable quest object. Represent 9, but 1 for client before 2.3.0
-                                break;
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint32(1);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown. not happen.
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_CHEST:
+                            *data << uint32(9);         // enable quest object. Represent 9, but 1 for client before 2.3.0
+                            break;
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint32(1);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown. not happen.
+                            break;
                     }
-                    else
-                        *data << uint32(0);                 // disable quest object
                 }
                 else
-                    *data << m_uint32Values[ index ];       // other cases
+                    *data << uint32(0);                 // disable quest object
             }
+            else
+                *data << m_uint32Values[ index ];       // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++ )
+        for (uint16 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index ) )
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[ index ];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[ index ];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    for (uint16 index = 0; index < m_valuesCount; index ++ )
-    {
-        if (m_uint32Values_mirror[index]!= m_uint32Values[index])
-            m_uint32Values_mirror[index] = m_uint32Values[index];
-    }
+    m_changedValues.Clear();
     if (m_objectUpdated)
     {
         if (remove)
-            ObjectAccessor::Instance().RemoveUpdateObject(this);
-        m_objectUpdated = false;
+            RemoveFromObjectUpdate();                       // resets m_objectUpdated
+        else
+            m_objectUpdated = false;
     }
 }
 
+// objects without a map (items) go to the global queue of ObjectAccessor
+// AddToObjectUpdate()/RemoveFromObjectUpdate() keep m_objectUpdated in step with the queue
+void Object::AddToObjectUpdate()
+{
+    ObjectAccessor::Instance().AddUpdateObject(this);
+    m_objectUpdated = true;
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    ObjectAccessor::Instance().RemoveUpdateObject(this);
+    m_objectUpdated = false;
+}
+
 // Send current value fields changes to all viewers
 void Object::SendUpdateObjectToAllExcept(Player* exceptPlayer)
 {
@@ -758,11 +807,7 @@ bool Object::LoadValues(const char* data)
 
 void Object::_SetUpdateBits(UpdateMask *updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; index ++ )
-    {
-        if (m_uint32Values_mirror[index]!= m_uint32Values[index])
-            updateMask->SetBit(index);
-    }
+    *updateMask |= m_changedValues;
 }
 
 void Object::_SetCreateBits(UpdateMask *updateMask, Player* /*target*/) const
@@ -781,14 +826,12 @@ void Object::SetInt32Value(uint16 index, int32 value )
     if (m_int32Values[ index ] != value)
     {
         m_int32Values[ index ] = value;
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -800,14 +843,12 @@ void Object::SetUInt32Value(uint16 index, uint32 value )
     if (m_uint32Values[ index ] != value)
     {
         m_uint32Values[ index ] = value;
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -819,14 +860,13 @@ void Object::SetUInt64Value(uint16 index, const uint64 &value )
     {
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -838,14 +878,12 @@ void Object::SetFloatValue(uint16 index, float value )
     if (m_floatValues[ index ] != value)
     {
         m_floatValues[ index ] = value;
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -864,14 +902,12 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value )
     {
         m_uint32Values[ index ] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 8));
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -890,14 +926,12 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value )
     {
         m_uint32Values[ index ] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 16));
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -959,14 +993,12 @@ void Object::SetFlag(uint16 index, uint32 newFlag )
     if (oldval != newval)
     {
         m_uint32Values[ index ] = newval;
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -980,14 +1012,12 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag )
     if (oldval != newval)
     {
         m_uint32Values[ index ] = newval;
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -1005,14 +1035,12 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag )
     if (!(uint8(m_uint32Values[ index ] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[ index ] |= uint32(uint32(newFlag) << (offset * 8));
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -1030,14 +1058,12 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag )
     if (uint8(m_uint32Values[ index ] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[ index ] &= ~uint32(uint32(oldFlag) << (offset * 8));
+        m_changedValues.SetBit(index);
 
         if (m_inWorld)
         {
             if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
+                AddToObjectUpdate();
         }
     }
 }
@@ -1060,6 +1086,8 @@ WorldObject::WorldObject()
     m_mapId             = 0;
     m_InstanceId        = 0;
     m_map               = NULL;
+    m_updateQueueSlot   = 0;
+    m_interestCell      = NO_INTEREST_CELL;
 
     m_name = "";
 
@@ -1223,6 +1251,28 @@ bool WorldObject::IsWithinLOSInMap(const WorldObject* obj) const
     return(IsWithinLOS(ox, oy, oz ));
 }
 
+void WorldObject::IsWithinLOSInMap(WorldObject const* const* objs, bool* result, uint32 count) const
+{
+    if (!count)
+        return;
+
+    std::vector<float> ox(count), oy(count), oz(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        objs[i]->GetPosition(ox[i], oy[i], oz[i]);
+        oz[i] += 2.0f;
+    }
+
+    float x,y,z;
+    GetPosition(x,y,z);
+    VMAP::IVMapManager *vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
+    vMapManager->isInLineOfSight(GetMapId(), x, y, z+2.0f, &ox[0], &oy[0], &oz[0], result, count);
+
+    for (uint32 i = 0; i < count; ++i)
+        if (!IsInMap(objs[i]))
+            result[i] = false;
+}
+
 bool WorldObject::IsWithinLOS(const float ox, const float oy, const float oz/*, Unit *targeter, Unit *target*/) const
 {	
 	/*
@@ -1453,14 +1503,11 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
-    m_uint32Values_mirror[i] = GetUInt32Value(i) + 1; // makes server think the field changed
+    m_changedValues.SetBit(i);
     if (m_inWorld)
     {
         if (!m_objectUpdated)
-        {
-            ObjectAccessor::Instance().AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+            AddToObjectUpdate();
     }
 }
 
@@ -1672,6 +1719,17 @@ void WorldObject::SendObjectDeSpawnAnim(uint64 guid)
     SendMessageToSet(&data, true);
 }
 
+// the map sets and resets m_objectUpdated under its queue lock
+void WorldObject::AddToObjectUpdate()
+{
+    GetMap()->AddUpdateObject(this);
+}
+
+void WorldObject::RemoveFromObjectUpdate()
+{
+    GetMap()->RemoveUpdateObject(this);
+}
+
 Map* WorldObject::_getMap()
 {
     return m_map = MapManager::Instance().GetMap(GetMapId(), this);
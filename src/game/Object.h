@@ -25,6 +25,7 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "GameSystem/GridReference.h"
 #include "ObjectDefines.h"
 #include "GridDefines.h"
@@ -100,6 +101,16 @@ class CreatureAI;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
+// Viewers of one class get the same values update block of an object
+enum UpdateViewerClass
+{
+    UPDATE_VIEWER_SELF      = 0,
+    UPDATE_VIEWER_GROUP     = 1,                            // other players in group or raid of a player
+    UPDATE_VIEWER_PUBLIC    = 2,
+    MAX_UPDATE_VIEWER_CLASS = 3,
+    UPDATE_VIEWER_UNIQUE    = MAX_UPDATE_VIEWER_CLASS       // block depends on the viewer itself
+};
+
 struct WorldLocation
 {
     uint32 mapid;
@@ -128,7 +139,7 @@ class NEO_DLL_SPEC Object
 
             m_inWorld = true;
 
-            // synchronize values mirror with values array (changes will send in updatecreate opcode any way
+            // drop changes done out of world (they will send in updatecreate opcode any way)
             ClearUpdateMask(true);
         }
         virtual void RemoveFromWorld()
@@ -157,6 +168,8 @@ class NEO_DLL_SPEC Object
         void SendUpdateToPlayer(Player* player);
 
         void BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target ) const;
+        void BuildValuesUpdateBlock(ByteBuffer *buf, Player *target ) const;
+        UpdateViewerClass GetUpdateViewerClass(Player *target ) const;
         void BuildOutOfRangeUpdateBlock(UpdateData *data ) const;
         void BuildMovementUpdateBlock(UpdateData * data, uint32 flags = 0 ) const;
         void BuildUpdate(UpdateDataMapType &);
@@ -299,6 +312,10 @@ class NEO_DLL_SPEC Object
         void ClearUpdateMask(bool remove);
         void SendUpdateObjectToAllExcept(Player* exceptPlayer);
 
+        // queue the object's changed fields are sent from
+        virtual void AddToObjectUpdate();
+        virtual void RemoveFromObjectUpdate();
+
         bool LoadValues(const char* data);
 
         uint16 GetValuesCount() const { return m_valuesCount; }
@@ -339,7 +356,8 @@ class NEO_DLL_SPEC Object
             float  *m_floatValues;
         };
 
-        uint32 *m_uint32Values_mirror;
+        // fields changed since the last values update, set by the value setters
+        UpdateMask m_changedValues;
 
         uint16 m_valuesCount;
 
@@ -479,6 +497,8 @@ class NEO_DLL_SPEC WorldObject : public Object, public WorldLocation
         }
         bool IsWithinLOS(const float x, const float y, const float z/*, Unit *targeter, Unit *target */) const;
         bool IsWithinLOSInMap(const WorldObject* obj) const;
+        // IsWithinLOSInMap() for count objects with one batched vmap query
+        void IsWithinLOSInMap(WorldObject const* const* objs, bool* result, uint32 count) const;
 
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
         bool IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D = true) const;
@@ -522,6 +542,10 @@ class NEO_DLL_SPEC WorldObject : public Object, public WorldLocation
         // Low Level Packets
         void SendPlaySound(uint32 Sound, bool OnlySelf);
 
+        // changed objects in world are queued in their map
+        void AddToObjectUpdate();
+        void RemoveFromObjectUpdate();
+
         Map      * GetMap() const   { return m_map ? m_map : const_cast<WorldObject*>(this)->_getMap(); }
         Map      * FindMap() const  { return m_map ? m_map : const_cast<WorldObject*>(this)->_findMap(); }
         Map const* GetBaseMap() const;
@@ -545,9 +569,13 @@ class NEO_DLL_SPEC WorldObject : public Object, public WorldLocation
         bool m_isActive;
 
     private:
+        friend class Map;
+
         uint32 m_mapId;
         uint32 m_InstanceId;
         Map    *m_map;
+        uint32 m_updateQueueSlot;                           // position in the update queue of the map
+        uint32 m_interestCell;                              // cell the map counts the update range of this active object around
 
         Map* _getMap();
         Map* _findMap();
@@ -41,6 +41,7 @@
 #include "World.h"
 
 #include <cmath>
+#include <ace/TSS_T.h>
 
 #define CLASS_LOCK Neo::ClassLevelLockable<ObjectAccessor, ACE_Thread_Mutex>
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
@@ -258,7 +259,7 @@ ObjectAccessor::FindPlayerByName(const char *name)
 void
 ObjectAccessor::SaveAllPlayers()
 {
-    Guard guard(*HashMapHolder<Player*>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard(*HashMapHolder<Player>::GetLock());
     HashMapHolder<Player>::MapType& m = HashMapHolder<Player>::GetContainer();
     HashMapHolder<Player>::MapType::iterator itr = m.begin();
     for (; itr != m.end(); ++itr)
@@ -544,6 +545,20 @@ ObjectAccessor::UpdatePlayers(uint32 diff)
             iter->second->Update(diff);
 }
 
+struct ViewerClassBlocks
+{
+    ByteBuffer blocks[MAX_UPDATE_VIEWER_CLASS];
+};
+
+static ACE_TSS<ViewerClassBlocks> viewerClassBlocks;
+
+ObjectAccessor::WorldObjectChangeAccumulator::WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d)
+    : i_updateDatas(d), i_object(obj), i_blocks(viewerClassBlocks->blocks)
+{
+    for (int i = 0; i < MAX_UPDATE_VIEWER_CLASS; ++i)
+        i_blockBuilt[i] = false;
+}
+
 void
 ObjectAccessor::WorldObjectChangeAccumulator::Visit(PlayerMapType &m)
 {
@@ -593,7 +608,18 @@ ObjectAccessor::WorldObjectChangeAccumulator::BuildPacket(Player* plr)
     // Only send update once to a player
     if (plr_list.find(plr->GetGUID()) == plr_list.end() && plr->HaveAtClient(&i_object))
     {
-        ObjectAccessor::_buildPacket(plr, &i_object, i_updateDatas);
+        UpdateViewerClass viewerClass = i_object.GetUpdateViewerClass(plr);
+        if (viewerClass == UPDATE_VIEWER_UNIQUE)
+            ObjectAccessor::_buildPacket(plr, &i_object, i_updateDatas);
+        else
+        {
+            if (!i_blockBuilt[viewerClass])
+            {
+                i_object.BuildValuesUpdateBlock(&i_blocks[viewerClass], plr);
+                i_blockBuilt[viewerClass] = true;
+            }
+            i_updateDatas[plr].AddUpdateBlock(i_blocks[viewerClass]);
+        }
         plr_list.insert(plr->GetGUID());
     }
 }
@@ -620,7 +646,7 @@ ObjectAccessor::UpdateObjectVisibility(WorldObject *obj)
 /// Define the static member of HashMapHolder
 
 template <class T> UNORDERED_MAP< uint64, T* > HashMapHolder<T>::m_objectMap;
-template <class T> ACE_Thread_Mutex HashMapHolder<T>::i_lock;
+template <class T> ShardedRWLock HashMapHolder<T>::i_lock;
 
 /// Global definitions for the hashmap storage
 
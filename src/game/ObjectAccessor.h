@@ -24,6 +24,9 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include <ace/Thread_Mutex.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/OS_NS_Thread.h>
+#include <ace/Guard_T.h>
 #include "Utilities/UnorderedMap.h"
 #include "Policies/ThreadingModel.h"
 
@@ -44,20 +47,91 @@ class DynamicObject;
 class WorldObject;
 class Map;
 
+// Reader/writer lock split into shards on their own cache lines. A reader only locks the shard
+// picked by its thread id, so lookups from different map threads don't bounce one shared lock
+// word between cores; a writer takes every shard in order. Writes get SHARD_COUNT times dearer.
+class ShardedRWLock
+{
+    public:
+        enum { SHARD_COUNT = 16 };
+
+        static uint32 ReaderShard()
+        {
+            // pthread ids are control block addresses, windows ids are multiples of 4
+            size_t id = size_t(ACE_OS::thr_self());
+            return uint32(((id >> 12) ^ (id >> 2)) % SHARD_COUNT);
+        }
+
+        void AcquireRead(uint32 shard) { i_shards[shard].lock.acquire_read(); }
+        void ReleaseRead(uint32 shard) { i_shards[shard].lock.release(); }
+
+        void AcquireWrite()
+        {
+            for (uint32 i = 0; i < SHARD_COUNT; ++i)
+                i_shards[i].lock.acquire_write();
+        }
+
+        void ReleaseWrite()
+        {
+            for (uint32 i = SHARD_COUNT; i > 0; --i)
+                i_shards[i - 1].lock.release();
+        }
+
+    private:
+        struct Shard
+        {
+            ACE_RW_Thread_Mutex lock;
+            char pad[64];
+        };
+
+        Shard i_shards[SHARD_COUNT];
+};
+
+// Global guid lookup, map threads look up concurrently while others insert and remove.
+// Lookups only take their shard of the lock, code iterating the container has to hold a
+// ReadGuard if objects may be added or removed by another thread meanwhile.
 template <class T>
 class HashMapHolder
 {
     public:
 
         typedef UNORDERED_MAP< uint64, T* >   MapType;
-        typedef ACE_Thread_Mutex LockType;
-        typedef Neo::GeneralLock<LockType > Guard;
+        typedef ShardedRWLock LockType;
 
-        static void Insert(T* o) { m_objectMap[o->GetGUID()] = o; }
+        class ReadGuard
+        {
+            public:
+                explicit ReadGuard(LockType& lock) : i_lock(lock), i_shard(LockType::ReaderShard()) { i_lock.AcquireRead(i_shard); }
+                ~ReadGuard() { i_lock.ReleaseRead(i_shard); }
+            private:
+                ReadGuard(ReadGuard const&);
+                ReadGuard& operator=(ReadGuard const&);
+
+                LockType& i_lock;
+                uint32 i_shard;
+        };
+
+        class WriteGuard
+        {
+            public:
+                explicit WriteGuard(LockType& lock) : i_lock(lock) { i_lock.AcquireWrite(); }
+                ~WriteGuard() { i_lock.ReleaseWrite(); }
+            private:
+                WriteGuard(WriteGuard const&);
+                WriteGuard& operator=(WriteGuard const&);
+
+                LockType& i_lock;
+        };
+
+        static void Insert(T* o)
+        {
+            WriteGuard guard(i_lock);
+            m_objectMap[o->GetGUID()] = o;
+        }
 
         static void Remove(T* o)
         {
-            Guard guard(i_lock);
+            WriteGuard guard(i_lock);
             typename MapType::iterator itr = m_objectMap.find(o->GetGUID());
             if (itr != m_objectMap.end())
                 m_objectMap.erase(itr);
@@ -65,7 +139,8 @@ class HashMapHolder
 
         static T* Find(uint64 guid)
         {
-            typename MapType::iterator itr = m_objectMap.find(guid);
+            ReadGuard guard(i_lock);
+            typename MapType::const_iterator itr = m_objectMap.find(guid);
             return (itr != m_objectMap.end()) ? itr->second : NULL;
         }
 
@@ -172,12 +247,6 @@ class NEO_DLL_DECL ObjectAccessor : public Neo::Singleton<ObjectAccessor, Neo::C
         void RemoveObject(Player *pl)
         {
             HashMapHolder<Player>::Remove(pl);
-
-            Guard guard(i_updateGuard);
-
-            std::set<Object *>::iterator iter2 = std::find(i_objects.begin(), i_objects.end(), (Object *)pl);
-            if (iter2 != i_objects.end() )
-                i_objects.erase(iter2);
         }
 
         void SaveAllPlayers();
@@ -206,7 +275,10 @@ class NEO_DLL_DECL ObjectAccessor : public Neo::Singleton<ObjectAccessor, Neo::C
             UpdateDataMapType &i_updateDatas;
             WorldObject &i_object;
             std::set<uint64> plr_list;
-            WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) {}
+            // values update block built once per viewer class, buffers are per thread
+            ByteBuffer* i_blocks;
+            bool i_blockBuilt[MAX_UPDATE_VIEWER_CLASS];
+            WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d);
             void Visit(PlayerMapType &);
             void Visit(CreatureMapType &);
             void Visit(DynamicObjectMapType &);
@@ -223,7 +295,7 @@ class NEO_DLL_DECL ObjectAccessor : public Neo::Singleton<ObjectAccessor, Neo::C
         static void _buildChangeObjectForPlayer(WorldObject *, UpdateDataMapType &);
         static void _buildPacket(Player *, Object *, UpdateDataMapType &);
         void _update(void);
-        std::set<Object *> i_objects;
+        std::set<Object *> i_objects;                       // changed objects without a map (items), the others are queued in their map
         LockType i_playerGuard;
         LockType i_updateGuard;
         LockType i_corpseGuard;
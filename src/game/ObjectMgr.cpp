@@ -4180,15 +4180,31 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
     //delete all old mails without item and without body immediately, if starting server
     if (!serverUp)
         CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
-    //                                                            0  1           2      3        4          5         6           7   8       9
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
+    //                                                            0  1           2      3        4          5         6           7   8       9              10      11    12
+    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId,subject,money,stationery FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
     if (!result )
         return;                                             // any mails need to be returned or deleted
+
+    // items of all expired mails in one go instead of a query per mail
+    typedef std::vector<MailItemInfo> MailItemInfoVec;
+    typedef UNORDERED_MAP<uint32, MailItemInfoVec> ExpiredMailItemsMap;
+    ExpiredMailItemsMap expiredItems;
+    //                                                                     0                  1                    2
+    QueryResult_AutoPtr resultItems = CharacterDatabase.PQuery("SELECT mail_items.mail_id, mail_items.item_guid, mail_items.item_template FROM mail JOIN mail_items ON mail_items.mail_id = mail.id WHERE mail.expire_time < '" UI64FMTD "'", (uint64)basetime);
+    if (resultItems)
+    {
+        do
+        {
+            Field *fields = resultItems->Fetch();
+            MailItemInfo mii;
+            mii.item_guid = fields[1].GetUInt32();
+            mii.item_template = fields[2].GetUInt32();
+            expiredItems[fields[0].GetUInt32()].push_back(mii);
+        } while (resultItems->NextRow());
+    }
+
+    std::ostringstream delitems, delmailitems, delmails, deltexts;
     Field *fields;
-    //std::ostringstream delitems, delmails; //will be here for optimization
-    //bool deletemail = false, deleteitem = false;
-    //delitems << "DELETE FROM item_instance WHERE guid IN (";
-    //delmails << "DELETE FROM mail WHERE id IN ("
     do
     {
         fields = result->Fetch();
@@ -4204,57 +4220,190 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         m->COD = fields[7].GetUInt32();
         m->checked = fields[8].GetUInt32();
         m->mailTemplateId = fields[9].GetInt16();
+        m->subject = fields[10].GetCppString();
+        m->money = fields[11].GetUInt32();
+        m->stationery = fields[12].GetUInt8();
 
         Player *pl = 0;
         if (serverUp)
             pl = GetPlayer((uint64)m->receiver);
         if (pl && pl->m_mailsLoaded)
-        {                                                   //this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            //his in mailbox and he has already listed his mails )
+        {                                                   // mailboxes are loaded at login, so every online receiver owns the mail in memory
+            ExpireOnlineReceiverMail(pl, m->messageID, basetime);
             delete m;
             continue;
         }
         //delete or return mail:
         if (has_items)
         {
-            QueryResult_AutoPtr resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field *fields2 = resultItems->Fetch();
-
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
+            ExpiredMailItemsMap::const_iterator itemsItr = expiredItems.find(m->messageID);
+            if (itemsItr != expiredItems.end())
+                m->items = itemsItr->second;
 
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
-            }
             //if it is mail from AH, it shouldn't be returned, but deleted
             if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_AUCTION | MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
             {
                 // mail open and then not returned
                 for (std::vector<MailItemInfo>::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                    CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", itr2->item_guid);
+                    delitems << (delitems.tellp() ? ", " : "") << itr2->item_guid;
+                delmailitems << (delmailitems.tellp() ? ", " : "") << m->messageID;
             }
             else
             {
                 //mail will be returned:
                 CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'", m->receiver, m->sender, (uint64)(basetime + 30*DAY), (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
-                delete m;
+                ModifyOfflineMailCount(m->receiver, -1);
+                ReturnMailToOnlineSender(m, basetime);
                 continue;
             }
         }
 
         if (m->itemTextId)
-            CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", m->itemTextId);
+            deltexts << (deltexts.tellp() ? ", " : "") << m->itemTextId;
 
-        //deletemail = true;
-        //delmails << m->messageID << ", ";
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
+        delmails << (delmails.tellp() ? ", " : "") << m->messageID;
+        ModifyOfflineMailCount(m->receiver, -1);
         delete m;
     } while (result->NextRow());
+
+    CharacterDatabase.BeginTransaction();
+    if (delitems.tellp())
+        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid IN (%s)", delitems.str().c_str());
+    if (delmailitems.tellp())
+        CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id IN (%s)", delmailitems.str().c_str());
+    if (deltexts.tellp())
+        CharacterDatabase.PExecute("DELETE FROM item_text WHERE id IN (%s)", deltexts.str().c_str());
+    if (delmails.tellp())
+        CharacterDatabase.PExecute("DELETE FROM mail WHERE id IN (%s)", delmails.str().c_str());
+    CharacterDatabase.CommitTransaction();
+}
+
+// an online sender keeps his mailbox in memory, so a returned mail has to be put there as well
+// takes ownership of m
+void ObjectMgr::ReturnMailToOnlineSender(Mail* m, time_t basetime)
+{
+    Player* sender = GetPlayer((uint64)m->sender);
+    if (!sender || !sender->m_mailsLoaded)
+    {
+        ModifyOfflineMailCount(m->sender, 1);
+        delete m;
+        return;
+    }
+
+    std::swap(m->sender, m->receiver);
+    m->expire_time = basetime + 30*DAY;
+    m->deliver_time = basetime;
+    m->COD = 0;
+    m->checked = MAIL_CHECK_MASK_RETURNED;
+    m->state = MAIL_STATE_UNCHANGED;
+
+    for (std::vector<MailItemInfo>::const_iterator itr = m->items.begin(); itr != m->items.end(); ++itr)
+    {
+        ItemPrototype const* proto = GetItemPrototype(itr->item_template);
+        if (!proto)
+            continue;
+
+        Item* item = NewItemOrBag(proto);
+        if (!item->LoadFromDB(itr->item_guid, 0))
+        {
+            delete item;
+            continue;
+        }
+        sender->AddMItem(item);
+    }
+
+    sender->AddMail(m);
+    sender->AddNewMailDeliverTime(basetime);
+}
+
+// an online receiver saves his mailbox over the DB rows, so an expired mail has to leave the mailbox itself
+void ObjectMgr::ExpireOnlineReceiverMail(Player* receiver, uint32 mailId, time_t basetime)
+{
+    Mail* m = receiver->GetMail(mailId);
+    if (!m || m->state == MAIL_STATE_DELETED)
+        return;
+
+    // same rule as for offline receivers, but on the in-memory copy, which may have lost items or money since the last save
+    bool returned = m->HasItems() && m->messageType == MAIL_NORMAL &&
+        !(m->checked & (MAIL_CHECK_MASK_AUCTION | MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED));
+
+    // the item objects leave the mailbox either way, the rows stay for the save or for the sender
+    for (std::vector<MailItemInfo>::const_iterator itr = m->items.begin(); itr != m->items.end(); ++itr)
+    {
+        if (Item* item = receiver->GetMItem(itr->item_guid))
+        {
+            receiver->RemoveMItem(itr->item_guid);
+            delete item;
+        }
+    }
+
+    if (!returned)
+    {
+        // items, text and the mail itself are deleted by the next Player::_SaveMail
+        m->state = MAIL_STATE_DELETED;
+        receiver->m_mailsUpdated = true;
+        receiver->UpdateNextMailTimeAndUnreads();
+        return;
+    }
+
+    receiver->RemoveMail(mailId);
+    receiver->UpdateNextMailTimeAndUnreads();
+
+    // write the unsaved in-memory state along with the return, items already taken must not go back to the sender
+    CharacterDatabase.BeginTransaction();
+    for (std::vector<uint32>::const_iterator itr = m->removedItems.begin(); itr != m->removedItems.end(); ++itr)
+        CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", *itr);
+    CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', itemTextId = '%u', has_items = '1', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "', money = '%u', cod = '0', checked = '%u' WHERE id = '%u'",
+        m->receiver, m->sender, m->itemTextId, (uint64)(basetime + 30*DAY), (uint64)basetime, m->money, MAIL_CHECK_MASK_RETURNED, m->messageID);
+    CharacterDatabase.CommitTransaction();
+    m->removedItems.clear();
+
+    ReturnMailToOnlineSender(m, basetime);
+}
+
+void ObjectMgr::LoadOfflineMailCounts()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_offlineMailCountsLock);
+    m_offlineMailCounts.clear();
+
+    QueryResult_AutoPtr result = CharacterDatabase.Query("SELECT receiver, COUNT(*) FROM mail GROUP BY receiver");
+    if (!result)
+        return;
+
+    do
+    {
+        Field *fields = result->Fetch();
+        m_offlineMailCounts[fields[0].GetUInt32()] = fields[1].GetUInt32();
+    } while (result->NextRow());
+
+    sLog.outString(">> Loaded mail counts for " SIZEFMTD " characters", m_offlineMailCounts.size());
+}
+
+uint32 ObjectMgr::GetOfflineMailCount(uint32 guidlow)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_offlineMailCountsLock);
+    OfflineMailCountMap::const_iterator itr = m_offlineMailCounts.find(guidlow);
+    return itr != m_offlineMailCounts.end() ? itr->second : 0;
+}
+
+void ObjectMgr::SetOfflineMailCount(uint32 guidlow, uint32 count)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_offlineMailCountsLock);
+    if (count)
+        m_offlineMailCounts[guidlow] = count;
+    else
+        m_offlineMailCounts.erase(guidlow);
+}
+
+void ObjectMgr::ModifyOfflineMailCount(uint32 guidlow, int32 diff)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_offlineMailCountsLock);
+    OfflineMailCountMap::iterator itr = m_offlineMailCounts.find(guidlow);
+    int32 count = (itr != m_offlineMailCounts.end() ? int32(itr->second) : 0) + diff;
+    if (count > 0)
+        m_offlineMailCounts[guidlow] = uint32(count);
+    else if (itr != m_offlineMailCounts.end())
+        m_offlineMailCounts.erase(itr);
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
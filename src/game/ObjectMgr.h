@@ -41,6 +41,8 @@
 #include "Policies/Singleton.h"
 #include "Database/SQLStorage.h"
 
+#include "ace/Thread_Mutex.h"
+
 #include <string>
 #include <map>
 #include <limits>
@@ -579,6 +581,14 @@ class ObjectMgr
         }
 
         void ReturnOrDeleteOldMails(bool serverUp);
+        void ReturnMailToOnlineSender(Mail* m, time_t basetime);
+        void ExpireOnlineReceiverMail(Player* receiver, uint32 mailId, time_t basetime);
+
+        // mail counts of offline characters, online ones use their in-memory mailbox
+        void LoadOfflineMailCounts();
+        uint32 GetOfflineMailCount(uint32 guidlow);
+        void SetOfflineMailCount(uint32 guidlow, uint32 count);
+        void ModifyOfflineMailCount(uint32 guidlow, int32 diff);
 
         void SetHighestGuids();
         uint32 GenerateLowGuid(HighGuid guidhigh);
@@ -799,6 +809,10 @@ class ObjectMgr
         uint32 m_auctionid;
         uint32 m_mailid;
         uint32 m_ItemTextId;
+
+        typedef UNORDERED_MAP<uint32, uint32> OfflineMailCountMap;
+        OfflineMailCountMap m_offlineMailCounts;
+        ACE_Thread_Mutex m_offlineMailCountsLock;           // mails are also sent from map threads
         uint32 m_arenaTeamId;
         uint32 m_guildId;
         uint32 m_hiPetNumber;
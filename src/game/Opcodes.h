@@ -1110,12 +1110,20 @@ enum SessionStatus
     STATUS_NEVER                                            ///< Opcode not accepted from client (deprecated or server side only)
 };
 
+/// Thread the handler of an opcode runs in
+enum PacketProcessing
+{
+    PROCESS_GLOBAL = 0,                                     ///< Touches global state, handled in World::UpdateSessions
+    PROCESS_MAP                                             ///< Touches only the player and its map, handled in the map's update thread
+};
+
 class WorldPacket;
 
 struct OpcodeHandler
 {
     char const* name;
     SessionStatus status;
+    PacketProcessing packetProcessing;
     void (WorldSession::*handler)(WorldPacket& recvPacket);
 };
 
@@ -231,14 +231,21 @@ void WorldSession::HandlePetitionShowSignOpcode(WorldPacket & recv_data)
                                                             // ok
     sLog.outDebug("Received opcode CMSG_PETITION_SHOW_SIGNATURES");
 
-    uint8 signs = 0;
     uint64 petitionguid;
     recv_data >> petitionguid;                              // petition guid
 
+    //                                  0              1
+    AsyncPQuery(&WorldSession::HandlePetitionShowSignContinuation, petitionguid,
+        "SELECT petition.type, petition_sign.playerguid FROM petition "
+        "LEFT JOIN petition_sign ON petition_sign.petitionguid = petition.petitionguid "
+        "WHERE petition.petitionguid = '%u'", GUID_LOPART(petitionguid));
+}
+
+void WorldSession::HandlePetitionShowSignContinuation(QueryResult_AutoPtr result, uint64 petitionguid)
+{
     // solve (possible) some strange compile problems with explicit use GUID_LOPART(petitionguid) at some GCC versions (wrong code optimization in compiler?)
     uint32 petitionguid_low = GUID_LOPART(petitionguid);
 
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT type FROM petition WHERE petitionguid = '%u'", petitionguid_low);
     if (!result)
     {
         sLog.outError("any petition on server...");
@@ -251,11 +258,8 @@ void WorldSession::HandlePetitionShowSignOpcode(WorldPacket & recv_data)
     if (type == 9 && _player->GetGuildId())
         return;
 
-    result = CharacterDatabase.PQuery("SELECT playerguid FROM petition_sign WHERE petitionguid = '%u'", petitionguid_low);
-
-    // result == NULL also correct in case no sign yet
-    if (result)
-        signs = result->GetRowCount();
+    // petition without signs yet still gives one row, with NULL signer
+    uint8 signs = fields[1].GetString() ? result->GetRowCount() : 0;
 
     sLog.outDebug("CMSG_PETITION_SHOW_SIGNATURES petition entry: '%u'", petitionguid_low);
 
@@ -268,7 +272,7 @@ void WorldSession::HandlePetitionShowSignOpcode(WorldPacket & recv_data)
     for (uint8 i = 1; i <= signs; ++i)
     {
         Field *fields = result->Fetch();
-        uint64 plguid = fields[0].GetUInt64();
+        uint64 plguid = fields[1].GetUInt64();
 
         data << plguid;                                     // Player GUID
         data << (uint32)0;                                  // there 0 ...
@@ -293,16 +297,19 @@ void WorldSession::HandlePetitionQueryOpcode(WorldPacket & recv_data)
 
 void WorldSession::SendPetitionQueryOpcode(uint64 petitionguid)
 {
-    uint64 ownerguid = 0;
-    uint32 type;
-    std::string name = "NO_NAME_FOR_GUID";
-    uint8 signs = 0;
-
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery(
+    AsyncPQuery(&WorldSession::SendPetitionQueryOpcodeContinuation, petitionguid,
         "SELECT ownerguid, name, "
         "  (SELECT COUNT(playerguid) FROM petition_sign WHERE petition_sign.petitionguid = '%u') AS signs, "
         "  type "
         "FROM petition WHERE petitionguid = '%u'", GUID_LOPART(petitionguid), GUID_LOPART(petitionguid));
+}
+
+void WorldSession::SendPetitionQueryOpcodeContinuation(QueryResult_AutoPtr result, uint64 petitionguid)
+{
+    uint64 ownerguid = 0;
+    uint32 type;
+    std::string name = "NO_NAME_FOR_GUID";
+    uint8 signs = 0;
 
     if (result)
     {
@@ -424,17 +431,24 @@ void WorldSession::HandlePetitionSignOpcode(WorldPacket & recv_data)
 {
     sLog.outDebug("Received opcode CMSG_PETITION_SIGN");
 
-    Field *fields;
     uint64 petitionguid;
     uint8 unk;
     recv_data >> petitionguid;                              // petition guid
     recv_data >> unk;
 
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery(
+    // signs of this account are fetched right away, saves a second round trip
+    AsyncPQuery(&WorldSession::HandlePetitionSignContinuation, petitionguid,
         "SELECT ownerguid, "
         "  (SELECT COUNT(playerguid) FROM petition_sign WHERE petition_sign.petitionguid = '%u') AS signs, "
-        "  type "
-        "FROM petition WHERE petitionguid = '%u'", GUID_LOPART(petitionguid), GUID_LOPART(petitionguid));
+        "  type, "
+        "  (SELECT COUNT(playerguid) FROM petition_sign WHERE player_account = '%u' AND petition_sign.petitionguid = '%u') AS account_signs "
+        "FROM petition WHERE petitionguid = '%u'",
+        GUID_LOPART(petitionguid), GetAccountId(), GUID_LOPART(petitionguid), GUID_LOPART(petitionguid));
+}
+
+void WorldSession::HandlePetitionSignContinuation(QueryResult_AutoPtr result, uint64 petitionguid)
+{
+    Field *fields;
 
     if (!result)
     {
@@ -446,6 +460,7 @@ void WorldSession::HandlePetitionSignOpcode(WorldPacket & recv_data)
     uint64 ownerguid = MAKE_NEW_GUID(fields[0].GetUInt32(), 0, HIGHGUID_PLAYER);
     uint8 signs = fields[1].GetUInt8();
     uint32 type = fields[2].GetUInt32();
+    bool signedByAccount = fields[3].GetUInt32() > 0;
 
     uint32 plguidlo = _player->GetGUIDLow();
     if (GUID_LOPART(ownerguid) == plguidlo)
@@ -504,9 +519,7 @@ void WorldSession::HandlePetitionSignOpcode(WorldPacket & recv_data)
 
     //client doesn't allow to sign petition two times by one character, but not check sign by another character from same account
     //not allow sign another player from already sign player account
-    result = CharacterDatabase.PQuery("SELECT playerguid FROM petition_sign WHERE player_account = '%u' AND petitionguid = '%u'", GetAccountId(), GUID_LOPART(petitionguid));
-
-    if (result)
+    if (signedByAccount)
     {
         WorldPacket data(SMSG_PETITION_SIGN_RESULTS, (8+8+4));
         data << petitionguid;
@@ -549,16 +562,20 @@ void WorldSession::HandlePetitionDeclineOpcode(WorldPacket & recv_data)
     sLog.outDebug("Received opcode MSG_PETITION_DECLINE");
 
     uint64 petitionguid;
-    uint64 ownerguid;
     recv_data >> petitionguid;                              // petition guid
     sLog.outDebug("Petition %u declined by %u", GUID_LOPART(petitionguid), _player->GetGUIDLow());
 
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT ownerguid FROM petition WHERE petitionguid = '%u'", GUID_LOPART(petitionguid));
+    AsyncPQuery(&WorldSession::HandlePetitionDeclineContinuation, petitionguid,
+        "SELECT ownerguid FROM petition WHERE petitionguid = '%u'", GUID_LOPART(petitionguid));
+}
+
+void WorldSession::HandlePetitionDeclineContinuation(QueryResult_AutoPtr result, uint64 /*petitionguid*/)
+{
     if (!result)
         return;
 
     Field *fields = result->Fetch();
-    ownerguid = MAKE_NEW_GUID(fields[0].GetUInt32(), 0, HIGHGUID_PLAYER);
+    uint64 ownerguid = MAKE_NEW_GUID(fields[0].GetUInt32(), 0, HIGHGUID_PLAYER);
 
     Player *owner = objmgr.GetPlayer(ownerguid);
     if (owner)                                               // petition owner online
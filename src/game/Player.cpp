@@ -295,6 +295,9 @@ Player::Player (WorldSession *session): Unit()
     // randomize first save time in range [CONFIG_INTERVAL_SAVE] around [CONFIG_INTERVAL_SAVE]
     // this must help in case next save after mass player load after server startup
     m_nextSave = GetMap()->urand(m_nextSave/2,m_nextSave*3/2);
+    m_autoSaveQueued = false;
+    m_significantChanges = false;
+    m_fallUnderMapPending = false;
 
     clearResurrectRequestData();
 
@@ -1248,13 +1251,13 @@ void Player::Update(uint32 p_time )
         KillPlayer();
     }
 
-    if (m_nextSave > 0)
+    if (m_nextSave > 0 && !m_autoSaveQueued)
     {
         if (p_time >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            sLog.outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // saved by World::ProcessAutoSaves, m_nextSave reseted in SaveToDB call
+            m_autoSaveQueued = true;
+            sWorld.ScheduleAutoSave(GetGUID());
         }
         else
         {
@@ -3652,6 +3655,24 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
     QueryResult_AutoPtr resultMail = CharacterDatabase.PQuery("SELECT id,mailTemplateId,sender,subject,itemTextId,money,has_items FROM mail WHERE receiver='%u' AND has_items<>0 AND cod<>0", guid);
     if (resultMail)
     {
+        // items of all these mails at once, not a query per mail
+        typedef std::multimap<uint32, MailItemInfo> CODMailItemsMap;
+        CODMailItemsMap codItems;
+        //                                                                     0                  1                    2
+        QueryResult_AutoPtr resultItems = CharacterDatabase.PQuery("SELECT mail_items.mail_id, mail_items.item_guid, mail_items.item_template FROM mail JOIN mail_items ON mail_items.mail_id = mail.id WHERE mail.receiver='%u' AND mail.has_items<>0 AND mail.cod<>0", guid);
+        if (resultItems)
+        {
+            do
+            {
+                Field *fields2 = resultItems->Fetch();
+                MailItemInfo mii;
+                mii.item_guid = fields2[1].GetUInt32();
+                mii.item_template = fields2[2].GetUInt32();
+                codItems.insert(CODMailItemsMap::value_type(fields2[0].GetUInt32(), mii));
+            }
+            while (resultItems->NextRow());
+        }
+
         do
         {
             Field *fields = resultMail->Fetch();
@@ -3671,34 +3692,28 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
             MailItemsInfo mi;
             if (has_items)
             {
-                QueryResult_AutoPtr resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", mail_id);
-                if (resultItems)
+                std::pair<CODMailItemsMap::const_iterator, CODMailItemsMap::const_iterator> range = codItems.equal_range(mail_id);
+                for (CODMailItemsMap::const_iterator itemItr = range.first; itemItr != range.second; ++itemItr)
                 {
-                    do
-                    {
-                        Field *fields2 = resultItems->Fetch();
+                    uint32 item_guidlow = itemItr->second.item_guid;
+                    uint32 item_template = itemItr->second.item_template;
 
-                        uint32 item_guidlow = fields2[0].GetUInt32();
-                        uint32 item_template = fields2[1].GetUInt32();
-
-                        ItemPrototype const* itemProto = objmgr.GetItemPrototype(item_template);
-                        if (!itemProto)
-                        {
-                            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guidlow);
-                            continue;
-                        }
-						
-                        Item *pItem = NewItemOrBag(itemProto);
-                        if (!pItem->LoadFromDB(item_guidlow, MAKE_NEW_GUID(guid, 0, HIGHGUID_PLAYER)))
-                        {
-                            pItem->FSetState(ITEM_REMOVED);
-                            pItem->SaveToDB();              // it also deletes item object !
-                            continue;
-                        }
+                    ItemPrototype const* itemProto = objmgr.GetItemPrototype(item_template);
+                    if (!itemProto)
+                    {
+                        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guidlow);
+                        continue;
+                    }
 
-                        mi.AddItem(pItem);
+                    Item *pItem = NewItemOrBag(itemProto);
+                    if (!pItem->LoadFromDB(item_guidlow, MAKE_NEW_GUID(guid, 0, HIGHGUID_PLAYER)))
+                    {
+                        pItem->FSetState(ITEM_REMOVED);
+                        pItem->SaveToDB();                  // it also deletes item object !
+                        continue;
                     }
-                    while (resultItems->NextRow());
+
+                    mi.AddItem(pItem);
                 }
             }
 
@@ -3750,6 +3765,8 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
     CharacterDatabase.PExecute("DELETE FROM character_pet_declinedname WHERE owner = '%u'",guid);
     CharacterDatabase.CommitTransaction();
 
+    objmgr.SetOfflineMailCount(guid, 0);
+
     //LoginDatabase.PExecute("UPDATE realmcharacters SET numchars = numchars - 1 WHERE acctid = %d AND realmid = %d", accountId, realmID);
     if (updateRealmChars) sWorld.UpdateRealmCharCount(accountId);
 }
@@ -14519,8 +14536,9 @@ bool Player::LoadFromDB(uint32 guid, SqlQueryHolder *holder )
 
     // apply original stats mods before spell loading or item equipment that call before equip _RemoveStatsMods()
 
-    //mails are loaded only when needed ;-) - when player in game click on mailbox.
-    //_LoadMail();
+    // mailbox and mailed items come with the login query holder, after that mails live in memory
+    // and are written back by _SaveMail, so mailbox opcodes never wait for the DB
+    _LoadMail(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILS), holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS));
 
     _LoadAuras(holder->GetResult(PLAYER_LOGIN_QUERY_LOADAURAS), time_diff);
 
@@ -14977,45 +14995,6 @@ void Player::_LoadInventory(QueryResult_AutoPtr result, uint32 timediff)
 }
 
 // load mailed item which should receive current player
-void Player::_LoadMailedItems(Mail *mail)
-{
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT item_guid, item_template FROM mail_items WHERE mail_id='%u'", mail->messageID);
-    if (!result)
-        return;
-
-    do
-    {
-        Field *fields = result->Fetch();
-        uint32 item_guid_low = fields[0].GetUInt32();
-        uint32 item_template = fields[1].GetUInt32();
-
-        mail->AddItem(item_guid_low, item_template);
-
-        ItemPrototype const *proto = objmgr.GetItemPrototype(item_template);
-
-        if (!proto)
-        {
-            sLog.outError("Player %u have unknown item_template (ProtoType) in mailed items(GUID: %u template: %u) in mail (%u), deleted.", GetGUIDLow(), item_guid_low, item_template,mail->messageID);
-            CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
-            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guid_low);
-            continue;
-        }
-
-        Item *item = NewItemOrBag(proto);
-
-        if (!item->LoadFromDB(item_guid_low, 0))
-        {
-            sLog.outError("Player::_LoadMailedItems - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, item_guid_low);
-            CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
-            item->FSetState(ITEM_REMOVED);
-            item->SaveToDB();                               // it also deletes item object !
-            continue;
-        }
-
-        AddMItem(item);
-    } while (result->NextRow());
-}
-
 void Player::_LoadMailInit(QueryResult_AutoPtr resultUnread, QueryResult_AutoPtr resultDelivery)
 {
     //set a count of unread mails
@@ -15037,14 +15016,28 @@ void Player::_LoadMailInit(QueryResult_AutoPtr resultUnread, QueryResult_AutoPtr
 
 void Player::_LoadMail()
 {
-    m_mail.clear();
     //mails are in right order                                    0  1           2      3        4       5          6         7           8            9     10  11      12         13
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId FROM mail WHERE receiver = '%u' ORDER BY id DESC",GetGUIDLow());
-    if (result)
+    QueryResult_AutoPtr resultMails = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId FROM mail WHERE receiver = '%u' ORDER BY id DESC",GetGUIDLow());
+    //                                                                        0                   1                  2                    3
+    QueryResult_AutoPtr resultItems = CharacterDatabase.PQuery("SELECT item_instance.data, mail_items.mail_id, mail_items.item_guid, mail_items.item_template FROM mail JOIN mail_items ON mail_items.mail_id = mail.id LEFT JOIN item_instance ON item_instance.guid = mail_items.item_guid WHERE mail.receiver = '%u'",GetGUIDLow());
+
+    _LoadMail(resultMails, resultItems);
+}
+
+void Player::_LoadMail(QueryResult_AutoPtr resultMails, QueryResult_AutoPtr resultItems)
+{
+    for (PlayerMails::iterator itr = m_mail.begin(); itr != m_mail.end(); ++itr)
+        delete *itr;
+    m_mail.clear();
+
+    typedef UNORDERED_MAP<uint32, Mail*> MailIdMap;
+    MailIdMap mailsById;
+
+    if (resultMails)
     {
         do
         {
-            Field *fields = result->Fetch();
+            Field *fields = resultMails->Fetch();
             Mail *m = new Mail;
             m->messageID = fields[0].GetUInt32();
             m->messageType = fields[1].GetUInt8();
@@ -15070,11 +15063,62 @@ void Player::_LoadMail()
             m->state = MAIL_STATE_UNCHANGED;
 
             if (has_items)
-                _LoadMailedItems(m);
+                mailsById[m->messageID] = m;
 
             m_mail.push_back(m);
-        } while (result->NextRow());
+        } while (resultMails->NextRow());
     }
+
+    // items of all mails come in one result, item data is joined in so no query per item is needed
+    if (resultItems && !mailsById.empty())
+    {
+        do
+        {
+            Field *fields = resultItems->Fetch();
+            uint32 mail_id = fields[1].GetUInt32();
+            uint32 item_guid_low = fields[2].GetUInt32();
+            uint32 item_template = fields[3].GetUInt32();
+
+            MailIdMap::const_iterator mailItr = mailsById.find(mail_id);
+            if (mailItr == mailsById.end())
+                continue;
+
+            Mail *mail = mailItr->second;
+            mail->AddItem(item_guid_low, item_template);
+
+            ItemPrototype const *proto = objmgr.GetItemPrototype(item_template);
+
+            if (!proto)
+            {
+                sLog.outError("Player %u have unknown item_template (ProtoType) in mailed items(GUID: %u template: %u) in mail (%u), deleted.", GetGUIDLow(), item_guid_low, item_template,mail->messageID);
+                CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
+                CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guid_low);
+                continue;
+            }
+
+            // NULL data: no item_instance row for this mailed item
+            if (!fields[0].GetString())
+            {
+                sLog.outError("Player::_LoadMail - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, item_guid_low);
+                CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
+                continue;
+            }
+
+            Item *item = NewItemOrBag(proto);
+
+            if (!item->LoadFromDB(item_guid_low, 0, resultItems))
+            {
+                sLog.outError("Player::_LoadMail - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, item_guid_low);
+                CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
+                item->FSetState(ITEM_REMOVED);
+                item->SaveToDB();                               // it also deletes item object !
+                continue;
+            }
+
+            AddMItem(item);
+        } while (resultItems->NextRow());
+    }
+
     m_mailsLoaded = true;
 }
 
@@ -15660,10 +15704,23 @@ bool Player::_LoadHomeBind(QueryResult_AutoPtr result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+// a player already waiting for his autosave is queued again, into the queue saved first
+void Player::SetSignificantChanges()
+{
+    if (m_significantChanges)
+        return;
+
+    m_significantChanges = true;
+    if (m_autoSaveQueued)
+        sWorld.ScheduleAutoSave(GetGUID());
+}
+
 void Player::SaveToDB()
 {
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld.getConfig(CONFIG_INTERVAL_SAVE);
+    m_autoSaveQueued = false;
+    m_significantChanges = false;
 
     // first save/honor gain after midnight will also update the player's honor fields
     UpdateHonorFields();
@@ -16034,6 +16091,8 @@ void Player::_SaveInventory()
         return;
     }
 
+    // the changes are written with a few multi-row statements at the end
+    ItemSaveBatch batch;
     for (size_t i = 0; i < m_itemUpdateQueue.size(); i++)
     {
         Item *item = m_itemUpdateQueue[i];
@@ -16045,20 +16104,19 @@ void Player::_SaveInventory()
         switch(item->GetState())
         {
             case ITEM_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ('%u', '%u', '%u', '%u', '%u')", GetGUIDLow(), bag_guid, item->GetSlot(), item->GetGUIDLow(), item->GetEntry());
-                break;
             case ITEM_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_inventory SET guid='%u', bag='%u', slot='%u', item_template='%u' WHERE item='%u'", GetGUIDLow(), bag_guid, item->GetSlot(), item->GetEntry(), item->GetGUIDLow());
+                batch.SaveInventory(item, GetGUIDLow(), bag_guid);
                 break;
             case ITEM_REMOVED:
-                CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item = '%u'", item->GetGUIDLow());
+                batch.DeleteInventory(item);
                 break;
             case ITEM_UNCHANGED:
                 break;
         }
 
-        item->SaveToDB();                                   // item have unchanged inventory record and can be save standalone
+        batch.SaveItem(item);                               // item have unchanged inventory record and can be save standalone
     }
+    batch.Execute();
     m_itemUpdateQueue.clear();
 }
 
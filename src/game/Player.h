@@ -836,6 +836,8 @@ enum PlayerLoginQueryIndex
     PLAYER_LOGIN_QUERY_LOADGUILD                = 17,
     PLAYER_LOGIN_QUERY_LOADARENAINFO            = 18,
     PLAYER_LOGIN_QUERY_LOADBGCOORD              = 19,
+    PLAYER_LOGIN_QUERY_LOADMAILS                = 20,
+    PLAYER_LOGIN_QUERY_LOADMAILEDITEMS          = 21,
 
     MAX_PLAYER_LOGIN_QUERY
 };
@@ -1349,6 +1351,9 @@ class NEO_DLL_SPEC Player : public Unit
             // "At Gold Limit"
             if (GetMoney() >= MAX_MONEY_AMOUNT)
                 SendEquipError(EQUIP_ERR_TOO_MUCH_GOLD,NULL,NULL);
+
+            if (d)
+                SetSignificantChanges();
         }
         void SetMoney(uint32 value )
         {
@@ -2017,6 +2022,10 @@ class NEO_DLL_SPEC Player : public Unit
 
         void HandleFallDamage(MovementInfo& movementInfo);
         void HandleFallUnderMap();
+        // the repop creates a corpse and may teleport to another map, so it waits for the world thread (WorldSession::Update)
+        void ScheduleFallUnderMap() { m_fallUnderMapPending = true; }
+        bool IsFallUnderMapPending() const { return m_fallUnderMapPending; }
+        void HandleScheduledFallUnderMap() { m_fallUnderMapPending = false; HandleFallUnderMap(); }
 
         void SetClientControl(Unit* target, uint8 allowMove);
 
@@ -2035,6 +2044,10 @@ class NEO_DLL_SPEC Player : public Unit
 
         uint32 GetSaveTimer() const { return m_nextSave; }
         void   SetSaveTimer(uint32 timer) { m_nextSave = timer; }
+        bool   IsAutoSaveQueued() const { return m_autoSaveQueued; }
+        // looted items or changed money, saved first when autosaves have to wait
+        void   SetSignificantChanges();
+        bool   HasSignificantChanges() const { return m_significantChanges; }
 
         // Recall position
         uint32 m_recallMap;
@@ -2187,7 +2200,7 @@ class NEO_DLL_SPEC Player : public Unit
         void _LoadInventory(QueryResult_AutoPtr result, uint32 timediff);
         void _LoadMailInit(QueryResult_AutoPtr resultUnread, QueryResult_AutoPtr resultDelivery);
         void _LoadMail();
-        void _LoadMailedItems(Mail *mail);
+        void _LoadMail(QueryResult_AutoPtr resultMails, QueryResult_AutoPtr resultItems);
         void _LoadQuestStatus(QueryResult_AutoPtr result);
         void _LoadDailyQuestStatus(QueryResult_AutoPtr result);
         void _LoadGroup(QueryResult_AutoPtr result);
@@ -2239,6 +2252,9 @@ class NEO_DLL_SPEC Player : public Unit
         uint32 m_class;
         uint32 m_team;
         uint32 m_nextSave;
+        bool m_autoSaveQueued;
+        bool m_significantChanges;
+        bool m_fallUnderMapPending;
         time_t m_speakTime;
         uint32 m_speakCount;
         uint32 m_dungeonDifficulty;
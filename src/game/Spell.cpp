@@ -50,6 +50,7 @@
 #include "TemporarySummon.h"
 
 #define SPELL_CHANNEL_UPDATE_INTERVAL 1000
+#define CHAIN_TARGET_LOS_BATCH 4
 
 extern pEffect SpellEffects[TOTAL_SPELL_EFFECTS];
 
@@ -1418,40 +1419,63 @@ void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uin
         if (tempUnitMap.empty())
             break;
 
-        std::list<Unit*>::iterator next;
+        if (TargetType != SPELL_TARGETS_CHAINHEAL)
+            tempUnitMap.sort(TargetDistanceOrder(cur));
+
+        std::list<Unit*>::iterator next = SelectNextChainTarget(cur, tempUnitMap, max_range, TargetType == SPELL_TARGETS_CHAINHEAL);
+        if (next == tempUnitMap.end())
+            return;
+
+        cur = *next;
+        tempUnitMap.erase(next);
+    }
+}
+
+// Next jump of a chain spell from cur. Candidates are checked for line of sight a few at a time,
+// each group with one batched vmap query. Unless chain healing, the candidates are sorted by distance from cur.
+std::list<Unit*>::iterator Spell::SelectNextChainTarget(Unit* cur, std::list<Unit*> &candidates, float max_range, bool chainHeal)
+{
+    std::list<Unit*>::iterator batch[CHAIN_TARGET_LOS_BATCH];
+    WorldObject const* objs[CHAIN_TARGET_LOS_BATCH];
+    bool los[CHAIN_TARGET_LOS_BATCH];
 
-        if (TargetType == SPELL_TARGETS_CHAINHEAL)
+    std::list<Unit*>::iterator itr = candidates.begin();
+    bool last = false;
+    while (!last)
+    {
+        uint32 count = 0;
+        for (; count < CHAIN_TARGET_LOS_BATCH && itr != candidates.end(); ++itr)
         {
-            next = tempUnitMap.begin();
-            while (cur->GetDistance(*next) > CHAIN_SPELL_JUMP_RADIUS
-                || !cur->IsWithinLOSInMap(*next))
+            if (cur->GetDistance(*itr) > CHAIN_SPELL_JUMP_RADIUS)
             {
-                ++next;
-                if (next == tempUnitMap.end())
-                    return;
+                // sorted by distance, all following candidates are out of range too
+                if (!chainHeal)
+                {
+                    last = true;
+                    break;
+                }
+                continue;
             }
-        }
-        else
-        {
-            tempUnitMap.sort(TargetDistanceOrder(cur));
-            next = tempUnitMap.begin();
+            if (!chainHeal && (m_spellInfo->DmgClass == SPELL_DAMAGE_CLASS_MELEE
+                && !m_caster->isInFront(*itr, max_range)
+                || !m_caster->canSeeOrDetect(*itr, false)))
+                continue;
 
-            if (cur->GetDistance(*next) > CHAIN_SPELL_JUMP_RADIUS)
-                break;
-            while (m_spellInfo->DmgClass == SPELL_DAMAGE_CLASS_MELEE
-                && !m_caster->isInFront(*next, max_range)
-                || !m_caster->canSeeOrDetect(*next, false)
-                || !cur->IsWithinLOSInMap(*next))
-            {
-                ++next;
-                if (next == tempUnitMap.end() || cur->GetDistance(*next) > CHAIN_SPELL_JUMP_RADIUS)
-                    return;
-            }
+            batch[count] = itr;
+            objs[count] = *itr;
+            ++count;
         }
+        if (itr == candidates.end())
+            last = true;
+        if (!count)
+            break;
 
-        cur = *next;
-        tempUnitMap.erase(next);
+        cur->IsWithinLOSInMap(objs, los, count);
+        for (uint32 i = 0; i < count; ++i)
+            if (los[i])
+                return batch[i];
     }
+    return candidates.end();
 }
 
 void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const uint32 type, SpellTargets TargetType, uint32 entry)
@@ -22,6 +22,7 @@
 #define __SPELL_H
 
 #include "GridDefines.h"
+#include "Utilities/ObjectPool.h"
 
 class Unit;
 class Player;
@@ -227,6 +228,8 @@ class Spell
 {
     friend struct Neo::SpellNotifierCreatureAndPlayer;
     public:
+        DECLARE_OBJECT_POOL(Spell)
+
 
         void EffectNULL(uint32);
         void EffectUnused(uint32);
@@ -559,6 +562,7 @@ class Spell
         bool IsAliveUnitPresentInTargetList();
         void SearchAreaTarget(std::list<Unit*> &unitList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0);
         void SearchChainTarget(std::list<Unit*> &unitList, float radius, uint32 unMaxTargets, SpellTargets TargetType);
+        std::list<Unit*>::iterator SelectNextChainTarget(Unit* cur, std::list<Unit*> &candidates, float max_range, bool chainHeal);
         WorldObject* SearchNearbyTarget(float range, SpellTargets TargetType);
         bool IsValidSingleTargetEffect(Unit const* target, Targets type) const;
         bool IsValidSingleTargetSpell(Unit const* target) const;
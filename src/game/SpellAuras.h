@@ -21,6 +21,7 @@
 #define NEO_SPELLAURAS_H
 
 #include "SpellAuraDefines.h"
+#include "Utilities/ObjectPool.h"
 
 struct DamageManaShield
 {
@@ -67,6 +68,8 @@ class NEO_DLL_SPEC Aura
 
     public:
         //aura handlers
+        DECLARE_OBJECT_POOL(Aura)
+
         void HandleNULL(bool, bool)
         {
             // NOT IMPLEMENTED
@@ -466,6 +466,7 @@ void Transport::TeleportTransport(uint32 newMapid, float x, float y, float z)
 
 bool Transport::AddPassenger(Player* passenger)
 {
+    ACE_Guard<ACE_Thread_Mutex> guard(m_passengersLock);
     if (m_passengers.find(passenger) == m_passengers.end())
     {
         sLog.outDetail("Player %s boarded transport %s.", passenger->GetName(), this->m_name.c_str());
@@ -476,6 +477,7 @@ bool Transport::AddPassenger(Player* passenger)
 
 bool Transport::RemovePassenger(Player* passenger)
 {
+    ACE_Guard<ACE_Thread_Mutex> guard(m_passengersLock);
     if (m_passengers.find(passenger) != m_passengers.end())
     {
         sLog.outDetail("Player %s removed from transport %s.", passenger->GetName(), this->m_name.c_str());
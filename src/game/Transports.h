@@ -23,6 +23,8 @@
 
 #include "GameObject.h"
 
+#include "ace/Thread_Mutex.h"
+
 #include <map>
 #include <set>
 #include <string>
@@ -72,6 +74,9 @@ class Transport : private GameObject
         using GameObject::GetPositionZ;
         using GameObject::BuildCreateUpdateBlockForPlayer;
         using GameObject::BuildOutOfRangeUpdateBlock;
+        // pooled allocation of GameObject, transports are bigger and always take the global allocator
+        using GameObject::operator new;
+        using GameObject::operator delete;
 
         bool Create(uint32 guidlow, uint32 mapid, float x, float y, float z, float ang, uint32 animprogress, uint32 dynflags);
         bool GenerateWaypoints(uint32 pathid, std::set<uint32> &mapids);
@@ -106,6 +111,7 @@ class Transport : private GameObject
         uint32 m_timer;
 
         PlayerSet m_passengers;
+        ACE_Thread_Mutex m_passengersLock;                  // boarding and leaving run in the map update threads
 
     public:
         WayPointMap m_WayPoints;
@@ -59,6 +59,8 @@ struct NEO_DLL_DECL Traveller
 
     void Relocation(float x, float y, float z, float orientation) {}
     void Relocation(float x, float y, float z) { Relocation(x, y, z, i_traveller.GetOrientation()); }
+    // relocation on the way to the destination, the client moves the unit on its own meanwhile
+    void PathStep(float x, float y, float z, float orientation) { Relocation(x, y, z, orientation); }
     void MoveTo(float x, float y, float z, uint32 t) {}
 };
 
@@ -94,6 +96,12 @@ inline void Traveller<Creature>::Relocation(float x, float y, float z, float ori
     MapManager::Instance().GetMap(i_traveller.GetMapId(), &i_traveller)->CreatureRelocation(&i_traveller, x, y, z, orientation);
 }
 
+template<>
+inline void Traveller<Creature>::PathStep(float x, float y, float z, float orientation)
+{
+    MapManager::Instance().GetMap(i_traveller.GetMapId(), &i_traveller)->CreatureRelocation(&i_traveller, x, y, z, orientation, true);
+}
+
 template<>
 inline float Traveller<Creature>::GetMoveDestinationTo(float x, float y, float z)
 {
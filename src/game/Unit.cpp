@@ -156,7 +156,7 @@ bool IsPassiveStackableSpell(uint32 spellId )
 
 Unit::Unit()
 : WorldObject(), i_motionMaster(this), m_ThreatManager(this), m_HostileRefManager(this)
-, m_IsInNotifyList(false), m_Notified(false), IsAIEnabled(false), NeedChangeAI(false)
+, m_IsInNotifyList(false), m_Notified(false), oldX(0.0f), oldY(0.0f), IsAIEnabled(false), NeedChangeAI(false)
 , i_AI(NULL), i_disabledAI(NULL), m_removedAurasCount(0), m_procDeep(0)
 {
     m_objectType |= TYPEMASK_UNIT;
@@ -11617,16 +11617,21 @@ Unit* Unit::SelectNearbyTarget(float dist) const
         targets.remove(getVictim());
 
     // remove not LoS targets
-    for (std::list<Unit *>::iterator tIter = targets.begin(); tIter != targets.end();)
+    if (!targets.empty())
     {
-        if (!IsWithinLOSInMap(*tIter))
+        std::vector<WorldObject const*> objs(targets.begin(), targets.end());
+        bool* los = new bool[objs.size()];
+        IsWithinLOSInMap(&objs[0], los, objs.size());
+
+        uint32 i = 0;
+        for (std::list<Unit *>::iterator tIter = targets.begin(); tIter != targets.end(); ++i)
         {
-            std::list<Unit *>::iterator tIter2 = tIter;
-            ++tIter;
-            targets.erase(tIter2);
+            if (!los[i])
+                tIter = targets.erase(tIter);
+            else
+                ++tIter;
         }
-        else
-            ++tIter;
+        delete[] los;
     }
 
     // no appropriate targets
@@ -21,14 +21,15 @@
 #ifndef __UPDATEMASK_H
 #define __UPDATEMASK_H
 
+#include "Platform/CompilerDefs.h"
 #include "UpdateFields.h"
 #include "Errors.h"
 
 class UpdateMask
 {
     public:
-        UpdateMask() : mCount(0 ), mBlocks(0 ), mUpdateMask(0 ) { }
-        UpdateMask(const UpdateMask& mask ) : mUpdateMask(0 ) { *this = mask; }
+        UpdateMask() : mCount(0 ), mBlocks(0 ), mCapacity(0 ), mUpdateMask(0 ) { }
+        UpdateMask(const UpdateMask& mask ) : mCapacity(0 ), mUpdateMask(0 ) { *this = mask; }
 
         ~UpdateMask()
         {
@@ -46,11 +47,31 @@ class UpdateMask
             ((uint8 *)mUpdateMask )[ index >> 3 ] &= (0xff ^ (1 <<  (index & 0x7 ) ));
         }
 
-        bool GetBit (uint32 index)
+        bool GetBit (uint32 index) const
         {
             return (((uint8 *)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7 ) )) != 0;
         }
 
+        // index of the first set bit at or after index, GetCount() if there is none
+        // skips a whole block of 32 unset bits per step
+        uint32 GetNextBit (uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = mUpdateMask[block] & (0xFFFFFFFF << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+                bits = mUpdateMask[block];
+            }
+
+            index = (block << 5) + LowestBit(bits);
+            return index < mCount ? index : mCount;
+        }
+
         uint32 GetBlockCount() { return mBlocks; }
         uint32 GetLength() { return mBlocks << 2; }
         uint32 GetCount() { return mCount; }
@@ -58,14 +79,20 @@ class UpdateMask
 
         void SetCount (uint32 valuesCount)
         {
-            if (mUpdateMask)
-                delete [] mUpdateMask;
-
             mCount = valuesCount;
             mBlocks = (valuesCount + 31) / 32;
 
-            mUpdateMask = new uint32[mBlocks];
-            memset(mUpdateMask, 0, mBlocks << 2);
+            // keep the storage of reused masks if it is big enough
+            if (mBlocks > mCapacity)
+            {
+                if (mUpdateMask)
+                    delete [] mUpdateMask;
+
+                mCapacity = mBlocks;
+                mUpdateMask = new uint32[mCapacity];
+            }
+            if (mUpdateMask)
+                memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         void Clear()
@@ -74,6 +101,14 @@ class UpdateMask
                 memset(mUpdateMask, 0, mBlocks << 2);
         }
 
+        // clears the bits set in mask
+        void UnsetBits(const UpdateMask& mask)
+        {
+            ASSERT(mask.mCount <= mCount);
+            for (uint32 i = 0; i < mask.mBlocks; i++)
+                mUpdateMask[i] &= ~mask.mUpdateMask[i];
+        }
+
         UpdateMask& operator = (const UpdateMask& mask )
         {
             SetCount(mask.mCount);
@@ -119,8 +154,21 @@ class UpdateMask
         }
 
     private:
+        static uint32 LowestBit(uint32 bits)
+        {
+#if COMPILER == COMPILER_GNU
+            return __builtin_ctz(bits);
+#else
+            uint32 index = 0;
+            while (!(bits & 0xFF)) { bits >>= 8; index += 8; }
+            while (!(bits & 1)) { bits >>= 1; ++index; }
+            return index;
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
+        uint32 mCapacity;
         uint32 *mUpdateMask;
 };
 #endif
@@ -187,7 +187,7 @@ WaypointMovementGenerator<Creature>::Update(Creature &unit, const uint32 &diff)
 
             //note: disable "start" for mtmap
             if (node->event_id && rand()%100 < node->event_chance)
-                sWorld.ScriptsStart(sWaypointScripts, node->event_id, &unit, NULL, false);
+                sWorld.ScriptsStart(sWaypointScripts, node->event_id, &unit, NULL);
 
             MovementInform(unit);
             unit.UpdateWaypointID(i_currentNode);
@@ -33,6 +33,7 @@
 #include "WorldPacket.h"
 #include "Weather.h"
 #include "Player.h"
+#include "ObjectAccessor.h"
 #include "SkillExtraItems.h"
 #include "SkillDiscovery.h"
 #include "World.h"
@@ -83,14 +84,6 @@ float World::m_MaxVisibleDistanceInFlight     = DEFAULT_VISIBILITY_DISTANCE;
 float World::m_VisibleUnitGreyDistance        = 0;
 float World::m_VisibleObjectGreyDistance      = 0;
 
-struct ScriptAction
-{
-    uint64 sourceGUID;
-    uint64 targetGUID;
-    uint64 ownerGUID;                                       // owner of source if source is item
-    ScriptInfo const* script;                               // pointer to static script data
-};
-
 /// World constructor
 World::World()
 {
@@ -114,6 +107,12 @@ World::World()
 
     m_updateTimeSum = 0;
     m_updateTimeCount = 0;
+
+    m_autoSaveCount = 0;
+    m_autoSaveDeferred = 0;
+    m_mapPacketsInMap = 0;
+    m_worldPacketsDeferred = 0;
+    m_mapPacketsInWorld = 0;
 }
 
 /// World destructor
@@ -607,6 +606,8 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_ADDON_CHANNEL] = sConfig.GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfig.GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfig.GetIntDefault("PlayerSaveInterval", 900000);
+    m_configs[CONFIG_INTERVAL_SAVE_MAX_PER_TICK] = sConfig.GetIntDefault("PlayerSave.MaxPerTick", 10);
+    m_configs[CONFIG_INTERVAL_SAVE_MAX_DB_QUEUE] = sConfig.GetIntDefault("PlayerSave.MaxDBQueue", 500);
     m_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = sConfig.GetIntDefault("DisconnectToleranceInterval", 0);
 
     m_configs[CONFIG_INTERVAL_GRIDCLEAN] = sConfig.GetIntDefault("GridCleanUpDelay", 300000);
@@ -627,6 +628,26 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         MapManager::Instance().SetMapUpdateInterval(m_configs[CONFIG_INTERVAL_MAPUPDATE]);
 
+    m_configs[CONFIG_GRID_PRELOAD_DISTANCE] = sConfig.GetIntDefault("GridPreload.Distance", 0);
+    m_configs[CONFIG_GRID_PRELOAD_PER_TICK] = sConfig.GetIntDefault("GridPreload.MaxPerTick", 1);
+    if (m_configs[CONFIG_GRID_PRELOAD_DISTANCE] && !m_configs[CONFIG_GRID_PRELOAD_PER_TICK])
+    {
+        sLog.outError("GridPreload.MaxPerTick (0) must be > 0 while GridPreload.Distance is set, grid preloading disabled.");
+        m_configs[CONFIG_GRID_PRELOAD_DISTANCE] = 0;
+    }
+
+    if (reload)
+    {
+        uint32 val = sConfig.GetIntDefault("RandomSeed", 0);
+        if (val != m_configs[CONFIG_RANDOM_SEED])
+            sLog.outError("RandomSeed option can't be changed at Neod.conf reload, using current value (%u).",m_configs[CONFIG_RANDOM_SEED]);
+    }
+    else
+    {
+        m_configs[CONFIG_RANDOM_SEED] = sConfig.GetIntDefault("RandomSeed", 0);
+        SetRandomSeed(m_configs[CONFIG_RANDOM_SEED]);
+    }
+
     m_configs[CONFIG_INTERVAL_CHANGEWEATHER] = sConfig.GetIntDefault("ChangeWeatherInterval", 600000);
 
     if (reload)
@@ -1082,13 +1103,15 @@ void World::LoadConfigSettings(bool reload)
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreMapIds = sConfig.GetStringDefault("vmap.ignoreMapIds", "");
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds", "");
+    uint32 modelCacheSize = sConfig.GetIntDefault("vmap.modelCacheSize", 0);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
     VMAP::VMapFactory::createOrGetVMapManager()->preventMapsFromBeingUsed(ignoreMapIds.c_str());
+    VMAP::VMapFactory::createOrGetVMapManager()->setModelCacheSize(modelCacheSize);
     VMAP::VMapFactory::preventSpellsFromBeingTestedForLoS(ignoreSpellIds.c_str());
     sLog.outString("WORLD: VMap support included. LineOfSight:%i, getHeight:%i",enableLOS, enableHeight);
     sLog.outString("WORLD: VMap data directory is: %svmaps",m_dataPath.c_str());
-    sLog.outString("WORLD: VMap config keys are: vmap.enableLOS, vmap.enableHeight, vmap.ignoreMapIds, vmap.ignoreSpellIds");
+    sLog.outString("WORLD: VMap config keys are: vmap.enableLOS, vmap.enableHeight, vmap.ignoreMapIds, vmap.ignoreSpellIds, vmap.modelCacheSize");
 	m_configs[CONFIG_MMAP_ENABLED] = sConfig.GetBoolDefault("MMap.enabled",false);
 
     m_configs[CONFIG_MAX_WHO] = sConfig.GetIntDefault("MaxWhoListReturns", 49);
@@ -1120,6 +1143,7 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfig.GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_configs[CONFIG_MIN_LOG_UPDATE] = sConfig.GetIntDefault("MinRecordUpdateTimeDiff", 10);
     m_configs[CONFIG_NUMTHREADS] = sConfig.GetIntDefault("MapUpdate.Threads",1);
+    m_configs[CONFIG_MAP_PACKETS] = sConfig.GetBoolDefault("MapUpdate.Packets", true);
 
     std::string forbiddenmaps = sConfig.GetStringDefault("ForbiddenMaps", "");
     char * forbiddenMaps = new char[forbiddenmaps.length() + 1];
@@ -1491,6 +1515,7 @@ void World::SetInitialWorldSettings()
     ///- Handle outdated emails (delete/return)
     sLog.outString("Returning old mails...");
     objmgr.ReturnOrDeleteOldMails(false);
+    objmgr.LoadOfflineMailCounts();
 
     sLog.outString("Loading Autobroadcasts...");
     LoadAutobroadcasts();
@@ -1870,6 +1895,10 @@ void World::Update(time_t diff)
         ///- Update objects when the timer has passed (maps, transport, creatures,...)
         MapManager::Instance().Update(diff);                // As interval = 0
 
+        RecordTimeDiff(NULL);
+        ProcessAutoSaves();
+        RecordTimeDiff("ProcessAutoSaves");
+
         RecordTimeDiff(NULL);
         ///- Process necessary scripts
         if (!m_scriptSchedule.empty())
@@ -1960,8 +1989,57 @@ void World::ForceGameEventUpdate()
     m_timers[WUPDATE_EVENTS].Reset();
 }
 
+// Objects of a map can be handled by its update only, items go with their owner
+// and transports travel between maps, so they stay in the world queue
+static WorldObject* GetScriptMapObject(Object* obj)
+{
+    if (!obj)
+        return NULL;
+
+    if (obj->GetTypeId() == TYPEID_ITEM)
+        return ((Item*)obj)->GetOwner();
+
+    if (!obj->isType(TYPEMASK_UNIT | TYPEMASK_GAMEOBJECT | TYPEMASK_DYNAMICOBJECT | TYPEMASK_CORPSE))
+        return NULL;
+
+    return (WorldObject*)obj;
+}
+
+static Map* GetScriptMap(Object* source)
+{
+    WorldObject* obj = GetScriptMapObject(source);
+    if (!obj || !obj->IsInWorld() || GUID_HIPART(obj->GetGUID()) == HIGHGUID_MO_TRANSPORT)
+        return NULL;
+
+    return obj->FindMap();
+}
+
+static bool IsOnScriptMap(Object* obj, Map* map)
+{
+    WorldObject* wobj = GetScriptMapObject(obj);
+    if (!wobj)
+        return obj == NULL || obj->GetTypeId() != TYPEID_ITEM;
+
+    return wobj->GetMapId() == map->GetId() && wobj->GetInstanceId() == map->GetInstanceId();
+}
+
+/// Queue a script action in the map that will execute it, or in the world queue
+void World::ScriptActionSchedule(Map* map, time_t when, ScriptAction const& sa)
+{
+    ++m_scheduledScripts;
+
+    if (map)
+    {
+        map->ScriptActionSchedule(when, sa);
+        return;
+    }
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_scriptScheduleLock);
+    m_scriptSchedule.insert(ScriptSchedule::value_type(when, sa));
+}
+
 /// Put scripts in the execution queue
-void World::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, Object* target, bool start)
+void World::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, Object* target)
 {
     ///- Find the script map
     ScriptMapMap::const_iterator s = scripts.find(id);
@@ -1972,10 +2050,10 @@ void World::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source,
     uint64 sourceGUID = source ? source->GetGUID() : (uint64)0; //some script commands doesn't have source
     uint64 targetGUID = target ? target->GetGUID() : (uint64)0;
     uint64 ownerGUID  = (source->GetTypeId()==TYPEID_ITEM) ? ((Item*)source)->GetOwnerGUID() : (uint64)0;
+    Map* map = GetScriptMap(source);
 
     ///- Schedule script execution for all scripts in the script map
     ScriptMap const *s2 = &(s->second);
-    bool immedScript = false;
     for (ScriptMap::const_iterator iter = s2->begin(); iter != s2->end(); ++iter)
     {
         ScriptAction sa;
@@ -1984,13 +2062,8 @@ void World::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source,
         sa.ownerGUID  = ownerGUID;
 
         sa.script = &iter->second;
-        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(m_gameTime + iter->first, sa));
-        if (iter->first == 0)
-            immedScript = true;
+        ScriptActionSchedule(map, m_gameTime + iter->first, sa);
     }
-    ///- If one of the effects should be immediate, launch the script execution
-    if (start && immedScript)
-        ScriptsProcess();
 }
 
 void World::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
@@ -2001,6 +2074,7 @@ void World::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* s
     uint64 sourceGUID = source ? source->GetGUID() : (uint64)0;
     uint64 targetGUID = target ? target->GetGUID() : (uint64)0;
     uint64 ownerGUID  = (source->GetTypeId()==TYPEID_ITEM) ? ((Item*)source)->GetOwnerGUID() : (uint64)0;
+    Map* map = GetScriptMap(source);
 
     ScriptAction sa;
     sa.sourceGUID = sourceGUID;
@@ -2008,733 +2082,747 @@ void World::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* s
     sa.ownerGUID  = ownerGUID;
 
     sa.script = &script;
-    m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(m_gameTime + delay, sa));
-
-    ///- If effects should be immediate, launch the script execution
-    if (delay == 0)
-        ScriptsProcess();
+    ScriptActionSchedule(map, m_gameTime + delay, sa);
 }
 
-/// Process queued scripts
+/// Process queued scripts of objects outside of maps
 void World::ScriptsProcess()
 {
-    if (m_scriptSchedule.empty())
-        return;
+    std::vector<ScriptAction> steps;
 
-    ///- Process overdue queued scripts
-    std::multimap<time_t, ScriptAction>::iterator iter = m_scriptSchedule.begin();
-                                                            // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= m_gameTime))
+    ///- Process overdue queued scripts, including the ones they queue for now
+    for (;;)
     {
-        ScriptAction const& step = iter->second;
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_scriptScheduleLock);
+            ScriptSchedule::iterator end = m_scriptSchedule.upper_bound(m_gameTime);
+            for (ScriptSchedule::iterator itr = m_scriptSchedule.begin(); itr != end; ++itr)
+                steps.push_back(itr->second);
+            m_scriptSchedule.erase(m_scriptSchedule.begin(), end);
+        }
+
+        if (steps.empty())
+            return;
+
+        for (std::vector<ScriptAction>::const_iterator itr = steps.begin(); itr != steps.end(); ++itr)
+            ScriptActionExecute(*itr, NULL);
+
+        ScriptActionDone(long(steps.size()));
+        steps.clear();
+    }
+}
 
-        Object* source = NULL;
+/// Execute a queued script action, map is the map whose update runs it or NULL on the world thread
+void World::ScriptActionExecute(ScriptAction const& step, Map* map)
+{
+    Object* source = NULL;
 
-        if (step.sourceGUID)
+    if (step.sourceGUID)
+    {
+        switch(GUID_HIPART(step.sourceGUID))
         {
-            switch(GUID_HIPART(step.sourceGUID))
-            {
-                case HIGHGUID_ITEM:
-                    // case HIGHGUID_CONTAINER: ==HIGHGUID_ITEM
-                    {
-                        Player* player = HashMapHolder<Player>::Find(step.ownerGUID);
-                        if (player)
-                            source = player->GetItemByGuid(step.sourceGUID);
-                        break;
-                    }
-                case HIGHGUID_UNIT:
-                    source = HashMapHolder<Creature>::Find(step.sourceGUID);
-                    break;
-                case HIGHGUID_PET:
-                    source = HashMapHolder<Pet>::Find(step.sourceGUID);
-                    break;
-                case HIGHGUID_PLAYER:
-                    source = HashMapHolder<Player>::Find(step.sourceGUID);
-                    break;
-                case HIGHGUID_GAMEOBJECT:
-                    source = HashMapHolder<GameObject>::Find(step.sourceGUID);
-                    break;
-                case HIGHGUID_CORPSE:
-                    source = HashMapHolder<Corpse>::Find(step.sourceGUID);
+            case HIGHGUID_ITEM:
+                // case HIGHGUID_CONTAINER: ==HIGHGUID_ITEM
+                {
+                    Player* player = HashMapHolder<Player>::Find(step.ownerGUID);
+                    if (player)
+                        source = player->GetItemByGuid(step.sourceGUID);
                     break;
-                case HIGHGUID_MO_TRANSPORT:
-                    for (MapManager::TransportSet::iterator iter = MapManager::Instance().m_Transports.begin(); iter != MapManager::Instance().m_Transports.end(); ++iter)
+                }
+            case HIGHGUID_UNIT:
+                source = HashMapHolder<Creature>::Find(step.sourceGUID);
+                break;
+            case HIGHGUID_PET:
+                source = HashMapHolder<Pet>::Find(step.sourceGUID);
+                break;
+            case HIGHGUID_PLAYER:
+                source = HashMapHolder<Player>::Find(step.sourceGUID);
+                break;
+            case HIGHGUID_GAMEOBJECT:
+                source = HashMapHolder<GameObject>::Find(step.sourceGUID);
+                break;
+            case HIGHGUID_CORPSE:
+                source = HashMapHolder<Corpse>::Find(step.sourceGUID);
+                break;
+            case HIGHGUID_MO_TRANSPORT:
+                for (MapManager::TransportSet::iterator iter = MapManager::Instance().m_Transports.begin(); iter != MapManager::Instance().m_Transports.end(); ++iter)
+                {
+                    if ((*iter)->GetGUID() == step.sourceGUID)
                     {
-                        if ((*iter)->GetGUID() == step.sourceGUID)
-                        {
-                            source = reinterpret_cast<Object*>(*iter);
-                            break;
-                        }
+                        source = reinterpret_cast<Object*>(*iter);
+                        break;
                     }
-                    break;
-                default:
-                    sLog.outError("*_script source with unsupported high guid value %u",GUID_HIPART(step.sourceGUID));
-                    break;
-            }
+                }
+                break;
+            default:
+                sLog.outError("*_script source with unsupported high guid value %u",GUID_HIPART(step.sourceGUID));
+                break;
+        }
+    }
+
+    //if (source && !source->IsInWorld()) source = NULL;
+
+    Object* target = NULL;
+
+    if (step.targetGUID)
+    {
+        switch(GUID_HIPART(step.targetGUID))
+        {
+            case HIGHGUID_UNIT:
+                target = HashMapHolder<Creature>::Find(step.targetGUID);
+                break;
+            case HIGHGUID_PET:
+                target = HashMapHolder<Pet>::Find(step.targetGUID);
+                break;
+            case HIGHGUID_PLAYER:                       // empty GUID case also
+                target = HashMapHolder<Player>::Find(step.targetGUID);
+                break;
+            case HIGHGUID_GAMEOBJECT:
+                target = HashMapHolder<GameObject>::Find(step.targetGUID);
+                break;
+            case HIGHGUID_CORPSE:
+                target = HashMapHolder<Corpse>::Find(step.targetGUID);
+                break;
+            default:
+                sLog.outError("*_script source with unsupported high guid value %u",GUID_HIPART(step.targetGUID));
+                break;
         }
+    }
 
-        //if (source && !source->IsInWorld()) source = NULL;
+    //if (target && !target->IsInWorld()) target = NULL;
 
-        Object* target = NULL;
+    // source or target changed map since the step was queued, map threads can't touch them now
+    if (map && (!IsOnScriptMap(source, map) || !IsOnScriptMap(target, map)))
+    {
+        ScriptActionSchedule(NULL, m_gameTime, step);
+        return;
+    }
 
-        if (step.targetGUID)
+    switch (step.script->command)
+    {
+        case SCRIPT_COMMAND_TALK:
         {
-            switch(GUID_HIPART(step.targetGUID))
+            if (!source)
             {
-                case HIGHGUID_UNIT:
-                    target = HashMapHolder<Creature>::Find(step.targetGUID);
-                    break;
-                case HIGHGUID_PET:
-                    target = HashMapHolder<Pet>::Find(step.targetGUID);
+                sLog.outError("SCRIPT_COMMAND_TALK call for NULL creature.");
+                break;
+            }
+
+            if (source->GetTypeId()!=TYPEID_UNIT)
+            {
+                sLog.outError("SCRIPT_COMMAND_TALK call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
+            if (step.script->datalong > 3)
+            {
+                sLog.outError("SCRIPT_COMMAND_TALK invalid chat type (%u), skipping.",step.script->datalong);
+                break;
+            }
+
+            uint64 unit_target = target ? target->GetGUID() : 0;
+
+            //datalong 0=normal say, 1=whisper, 2=yell, 3=emote text
+            switch(step.script->datalong)
+            {
+                case 0:                                 // Say
+                    source->ToCreature()->Say(step.script->dataint, LANG_UNIVERSAL, unit_target);
                     break;
-                case HIGHGUID_PLAYER:                       // empty GUID case also
-                    target = HashMapHolder<Player>::Find(step.targetGUID);
+                case 1:                                 // Whisper
+                    if (!unit_target)
+                    {
+                        sLog.outError("SCRIPT_COMMAND_TALK attempt to whisper (%u) NULL, skipping.",step.script->datalong);
+                        break;
+                    }
+                    source->ToCreature()->Whisper(step.script->dataint,unit_target);
                     break;
-                case HIGHGUID_GAMEOBJECT:
-                    target = HashMapHolder<GameObject>::Find(step.targetGUID);
+                case 2:                                 // Yell
+                    source->ToCreature()->Yell(step.script->dataint, LANG_UNIVERSAL, unit_target);
                     break;
-                case HIGHGUID_CORPSE:
-                    target = HashMapHolder<Corpse>::Find(step.targetGUID);
+                case 3:                                 // Emote text
+                    source->ToCreature()->TextEmote(step.script->dataint, unit_target);
                     break;
                 default:
-                    sLog.outError("*_script source with unsupported high guid value %u",GUID_HIPART(step.targetGUID));
-                    break;
+                    break;                              // must be already checked at load
             }
+            break;
         }
 
-        //if (target && !target->IsInWorld()) target = NULL;
-
-        switch (step.script->command)
-        {
-            case SCRIPT_COMMAND_TALK:
+        case SCRIPT_COMMAND_EMOTE:
+            if (!source)
             {
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TALK call for NULL creature.");
-                    break;
-                }
-
-                if (source->GetTypeId()!=TYPEID_UNIT)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TALK call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
-                if (step.script->datalong > 3)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TALK invalid chat type (%u), skipping.",step.script->datalong);
-                    break;
-                }
-
-                uint64 unit_target = target ? target->GetGUID() : 0;
-
-                //datalong 0=normal say, 1=whisper, 2=yell, 3=emote text
-                switch(step.script->datalong)
-                {
-                    case 0:                                 // Say
-                        source->ToCreature()->Say(step.script->dataint, LANG_UNIVERSAL, unit_target);
-                        break;
-                    case 1:                                 // Whisper
-                        if (!unit_target)
-                        {
-                            sLog.outError("SCRIPT_COMMAND_TALK attempt to whisper (%u) NULL, skipping.",step.script->datalong);
-                            break;
-                        }
-                        source->ToCreature()->Whisper(step.script->dataint,unit_target);
-                        break;
-                    case 2:                                 // Yell
-                        source->ToCreature()->Yell(step.script->dataint, LANG_UNIVERSAL, unit_target);
-                        break;
-                    case 3:                                 // Emote text
-                        source->ToCreature()->TextEmote(step.script->dataint, unit_target);
-                        break;
-                    default:
-                        break;                              // must be already checked at load
-                }
+                sLog.outError("SCRIPT_COMMAND_EMOTE call for NULL creature.");
                 break;
             }
 
-            case SCRIPT_COMMAND_EMOTE:
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_EMOTE call for NULL creature.");
-                    break;
-                }
-
-                if (source->GetTypeId()!=TYPEID_UNIT)
-                {
-                    sLog.outError("SCRIPT_COMMAND_EMOTE call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            if (source->GetTypeId()!=TYPEID_UNIT)
+            {
+                sLog.outError("SCRIPT_COMMAND_EMOTE call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                source->ToCreature()->HandleEmoteCommand(step.script->datalong);
+            source->ToCreature()->HandleEmoteCommand(step.script->datalong);
+            break;
+        case SCRIPT_COMMAND_FIELD_SET:
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_FIELD_SET call for NULL object.");
                 break;
-            case SCRIPT_COMMAND_FIELD_SET:
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_FIELD_SET call for NULL object.");
-                    break;
-                }
-                if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
-                {
-                    sLog.outError("SCRIPT_COMMAND_FIELD_SET call for wrong field %u (max count: %u) in object (TypeId: %u).",
-                        step.script->datalong,source->GetValuesCount(),source->GetTypeId());
-                    break;
-                }
+            }
+            if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
+            {
+                sLog.outError("SCRIPT_COMMAND_FIELD_SET call for wrong field %u (max count: %u) in object (TypeId: %u).",
+                    step.script->datalong,source->GetValuesCount(),source->GetTypeId());
+                break;
+            }
 
-                source->SetUInt32Value(step.script->datalong, step.script->datalong2);
+            source->SetUInt32Value(step.script->datalong, step.script->datalong2);
+            break;
+        case SCRIPT_COMMAND_MOVE_TO:
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_MOVE_TO call for NULL creature.");
                 break;
-            case SCRIPT_COMMAND_MOVE_TO:
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_MOVE_TO call for NULL creature.");
-                    break;
-                }
+            }
 
-                if (source->GetTypeId()!=TYPEID_UNIT)
-                {
-                    sLog.outError("SCRIPT_COMMAND_MOVE_TO call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
-                ((Unit *)source)->SendMonsterMoveWithSpeed(step.script->x, step.script->y, step.script->z, step.script->datalong2);
-                ((Unit *)source)->GetMap()->CreatureRelocation(source->ToCreature(), step.script->x, step.script->y, step.script->z, 0);
+            if (source->GetTypeId()!=TYPEID_UNIT)
+            {
+                sLog.outError("SCRIPT_COMMAND_MOVE_TO call for non-creature (TypeId: %u), skipping.",source->GetTypeId());
                 break;
-            case SCRIPT_COMMAND_FLAG_SET:
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_FLAG_SET call for NULL object.");
-                    break;
-                }
-                if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
-                {
-                    sLog.outError("SCRIPT_COMMAND_FLAG_SET call for wrong field %u (max count: %u) in object (TypeId: %u).",
-                        step.script->datalong,source->GetValuesCount(),source->GetTypeId());
-                    break;
-                }
+            }
+            ((Unit *)source)->SendMonsterMoveWithSpeed(step.script->x, step.script->y, step.script->z, step.script->datalong2);
+            ((Unit *)source)->GetMap()->CreatureRelocation(source->ToCreature(), step.script->x, step.script->y, step.script->z, 0);
+            break;
+        case SCRIPT_COMMAND_FLAG_SET:
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_FLAG_SET call for NULL object.");
+                break;
+            }
+            if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
+            {
+                sLog.outError("SCRIPT_COMMAND_FLAG_SET call for wrong field %u (max count: %u) in object (TypeId: %u).",
+                    step.script->datalong,source->GetValuesCount(),source->GetTypeId());
+                break;
+            }
 
-                source->SetFlag(step.script->datalong, step.script->datalong2);
+            source->SetFlag(step.script->datalong, step.script->datalong2);
+            break;
+        case SCRIPT_COMMAND_FLAG_REMOVE:
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_FLAG_REMOVE call for NULL object.");
                 break;
-            case SCRIPT_COMMAND_FLAG_REMOVE:
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_FLAG_REMOVE call for NULL object.");
-                    break;
-                }
-                if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
-                {
-                    sLog.outError("SCRIPT_COMMAND_FLAG_REMOVE call for wrong field %u (max count: %u) in object (TypeId: %u).",
-                        step.script->datalong,source->GetValuesCount(),source->GetTypeId());
-                    break;
-                }
+            }
+            if (step.script->datalong <= OBJECT_FIELD_ENTRY || step.script->datalong >= source->GetValuesCount())
+            {
+                sLog.outError("SCRIPT_COMMAND_FLAG_REMOVE call for wrong field %u (max count: %u) in object (TypeId: %u).",
+                    step.script->datalong,source->GetValuesCount(),source->GetTypeId());
+                break;
+            }
 
-                source->RemoveFlag(step.script->datalong, step.script->datalong2);
+            source->RemoveFlag(step.script->datalong, step.script->datalong2);
+            break;
+
+        case SCRIPT_COMMAND_TELEPORT_TO:
+        {
+            // accept player in any one from target/source arg
+            if (!target && !source)
+            {
+                sLog.outError("SCRIPT_COMMAND_TELEPORT_TO call for NULL object.");
                 break;
+            }
 
-            case SCRIPT_COMMAND_TELEPORT_TO:
+                                                        // must be only Player
+            if ((!target || target->GetTypeId() != TYPEID_PLAYER) && (!source || source->GetTypeId() != TYPEID_PLAYER))
             {
-                // accept player in any one from target/source arg
-                if (!target && !source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TELEPORT_TO call for NULL object.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_TELEPORT_TO call for non-player (TypeIdSource: %u)(TypeIdTarget: %u), skipping.", source ? source->GetTypeId() : 0, target ? target->GetTypeId() : 0);
+                break;
+            }
 
-                                                            // must be only Player
-                if ((!target || target->GetTypeId() != TYPEID_PLAYER) && (!source || source->GetTypeId() != TYPEID_PLAYER))
-                {
-                    sLog.outError("SCRIPT_COMMAND_TELEPORT_TO call for non-player (TypeIdSource: %u)(TypeIdTarget: %u), skipping.", source ? source->GetTypeId() : 0, target ? target->GetTypeId() : 0);
-                    break;
-                }
+            Player* pSource = target && target->GetTypeId() == TYPEID_PLAYER ? target->ToPlayer() : source->ToPlayer();
 
-                Player* pSource = target && target->GetTypeId() == TYPEID_PLAYER ? target->ToPlayer() : source->ToPlayer();
+            pSource->TeleportTo(step.script->datalong, step.script->x, step.script->y, step.script->z, step.script->o);
+            break;
+        }
 
-                pSource->TeleportTo(step.script->datalong, step.script->x, step.script->y, step.script->z, step.script->o);
+        case SCRIPT_COMMAND_TEMP_SUMMON_CREATURE:
+        {
+            if (!step.script->datalong)                  // creature not specified
+            {
+                sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for NULL creature.");
                 break;
             }
 
-            case SCRIPT_COMMAND_TEMP_SUMMON_CREATURE:
+            if (!source)
             {
-                if (!step.script->datalong)                  // creature not specified
-                {
-                    sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for NULL creature.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for NULL world object.");
+                break;
+            }
 
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for NULL world object.");
-                    break;
-                }
+            WorldObject* summoner = dynamic_cast<WorldObject*>(source);
 
-                WorldObject* summoner = dynamic_cast<WorldObject*>(source);
+            if (!summoner)
+            {
+                sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for non-WorldObject (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                if (!summoner)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON_CREATURE call for non-WorldObject (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            float x = step.script->x;
+            float y = step.script->y;
+            float z = step.script->z;
+            float o = step.script->o;
 
-                float x = step.script->x;
-                float y = step.script->y;
-                float z = step.script->z;
-                float o = step.script->o;
+            Creature* pCreature = summoner->SummonCreature(step.script->datalong, x, y, z, o,TEMPSUMMON_TIMED_OR_DEAD_DESPAWN,step.script->datalong2);
+            if (!pCreature)
+            {
+                sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON failed for creature (entry: %u).",step.script->datalong);
+                break;
+            }
 
-                Creature* pCreature = summoner->SummonCreature(step.script->datalong, x, y, z, o,TEMPSUMMON_TIMED_OR_DEAD_DESPAWN,step.script->datalong2);
-                if (!pCreature)
-                {
-                    sLog.outError("SCRIPT_COMMAND_TEMP_SUMMON failed for creature (entry: %u).",step.script->datalong);
-                    break;
-                }
+            break;
+        }
 
+        case SCRIPT_COMMAND_RESPAWN_GAMEOBJECT:
+        {
+            if (!step.script->datalong)                  // gameobject not specified
+            {
+                sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for NULL gameobject.");
                 break;
             }
 
-            case SCRIPT_COMMAND_RESPAWN_GAMEOBJECT:
+            if (!source)
             {
-                if (!step.script->datalong)                  // gameobject not specified
-                {
-                    sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for NULL gameobject.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for NULL world object.");
+                break;
+            }
 
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for NULL world object.");
-                    break;
-                }
+            WorldObject* summoner = dynamic_cast<WorldObject*>(source);
 
-                WorldObject* summoner = dynamic_cast<WorldObject*>(source);
+            if (!summoner)
+            {
+                sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for non-WorldObject (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                if (!summoner)
-                {
-                    sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT call for non-WorldObject (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            GameObject *go = NULL;
+            int32 time_to_despawn = step.script->datalong2<5 ? 5 : (int32)step.script->datalong2;
 
-                GameObject *go = NULL;
-                int32 time_to_despawn = step.script->datalong2<5 ? 5 : (int32)step.script->datalong2;
+            CellPair p(Neo::ComputeCellPair(summoner->GetPositionX(), summoner->GetPositionY()));
+            Cell cell(p);
+            cell.data.Part.reserved = ALL_DISTRICT;
 
-                CellPair p(Neo::ComputeCellPair(summoner->GetPositionX(), summoner->GetPositionY()));
-                Cell cell(p);
-                cell.data.Part.reserved = ALL_DISTRICT;
+            Neo::GameObjectWithDbGUIDCheck go_check(*summoner,step.script->datalong);
+            Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(go,go_check);
 
-                Neo::GameObjectWithDbGUIDCheck go_check(*summoner,step.script->datalong);
-                Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(go,go_check);
+            TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
+            CellLock<GridReadGuard> cell_lock(cell, p);
+            cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(summoner->GetMapId(), summoner));
 
-                TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
-                CellLock<GridReadGuard> cell_lock(cell, p);
-                cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(summoner->GetMapId(), summoner));
+            if (!go )
+            {
+                sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT failed for gameobject(guid: %u).", step.script->datalong);
+                break;
+            }
 
-                if (!go )
-                {
-                    sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT failed for gameobject(guid: %u).", step.script->datalong);
-                    break;
-                }
-
-                if (go->GetGoType()==GAMEOBJECT_TYPE_FISHINGNODE ||
-                    go->GetGoType()==GAMEOBJECT_TYPE_DOOR        ||
-                    go->GetGoType()==GAMEOBJECT_TYPE_BUTTON      ||
-                    go->GetGoType()==GAMEOBJECT_TYPE_TRAP )
-                {
-                    sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT can not be used with gameobject of type %u (guid: %u).", uint32(go->GetGoType()), step.script->datalong);
-                    break;
-                }
+            if (go->GetGoType()==GAMEOBJECT_TYPE_FISHINGNODE ||
+                go->GetGoType()==GAMEOBJECT_TYPE_DOOR        ||
+                go->GetGoType()==GAMEOBJECT_TYPE_BUTTON      ||
+                go->GetGoType()==GAMEOBJECT_TYPE_TRAP )
+            {
+                sLog.outError("SCRIPT_COMMAND_RESPAWN_GAMEOBJECT can not be used with gameobject of type %u (guid: %u).", uint32(go->GetGoType()), step.script->datalong);
+                break;
+            }
 
-                if (go->isSpawned() )
-                    break;                                  //gameobject already spawned
+            if (go->isSpawned() )
+                break;                                  //gameobject already spawned
 
-                go->SetLootState(GO_READY);
-                go->SetRespawnTime(time_to_despawn);        //despawn object in ? seconds
+            go->SetLootState(GO_READY);
+            go->SetRespawnTime(time_to_despawn);        //despawn object in ? seconds
 
-                go->GetMap()->Add(go);
+            go->GetMap()->Add(go);
+            break;
+        }
+        case SCRIPT_COMMAND_OPEN_DOOR:
+        {
+            if (!step.script->datalong)                  // door not specified
+            {
+                sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for NULL door.");
                 break;
             }
-            case SCRIPT_COMMAND_OPEN_DOOR:
-            {
-                if (!step.script->datalong)                  // door not specified
-                {
-                    sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for NULL door.");
-                    break;
-                }
 
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for NULL unit.");
-                    break;
-                }
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for NULL unit.");
+                break;
+            }
 
-                if (!source->isType(TYPEMASK_UNIT))          // must be any Unit (creature or player)
-                {
-                    sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for non-unit (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            if (!source->isType(TYPEMASK_UNIT))          // must be any Unit (creature or player)
+            {
+                sLog.outError("SCRIPT_COMMAND_OPEN_DOOR call for non-unit (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                Unit* caster = (Unit*)source;
+            Unit* caster = (Unit*)source;
 
-                GameObject *door = NULL;
-                int32 time_to_close = step.script->datalong2 < 15 ? 15 : (int32)step.script->datalong2;
+            GameObject *door = NULL;
+            int32 time_to_close = step.script->datalong2 < 15 ? 15 : (int32)step.script->datalong2;
 
-                CellPair p(Neo::ComputeCellPair(caster->GetPositionX(), caster->GetPositionY()));
-                Cell cell(p);
-                cell.data.Part.reserved = ALL_DISTRICT;
+            CellPair p(Neo::ComputeCellPair(caster->GetPositionX(), caster->GetPositionY()));
+            Cell cell(p);
+            cell.data.Part.reserved = ALL_DISTRICT;
 
-                Neo::GameObjectWithDbGUIDCheck go_check(*caster,step.script->datalong);
-                Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(door,go_check);
+            Neo::GameObjectWithDbGUIDCheck go_check(*caster,step.script->datalong);
+            Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(door,go_check);
 
-                TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
-                CellLock<GridReadGuard> cell_lock(cell, p);
-                cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(caster->GetMapId(), (Unit*)source));
+            TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
+            CellLock<GridReadGuard> cell_lock(cell, p);
+            cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(caster->GetMapId(), (Unit*)source));
 
-                if (!door )
-                {
-                    sLog.outError("SCRIPT_COMMAND_OPEN_DOOR failed for gameobject(guid: %u).", step.script->datalong);
-                    break;
-                }
-                if (door->GetGoType() != GAMEOBJECT_TYPE_DOOR )
-                {
-                    sLog.outError("SCRIPT_COMMAND_OPEN_DOOR failed for non-door(GoType: %u).", door->GetGoType());
-                    break;
-                }
-
-                if (!door->GetGoState() )
-                    break;                                  //door already  open
-
-                door->UseDoorOrButton(time_to_close);
-
-                if (target && target->isType(TYPEMASK_GAMEOBJECT) && ((GameObject*)target)->GetGoType()==GAMEOBJECT_TYPE_BUTTON)
-                    ((GameObject*)target)->UseDoorOrButton(time_to_close);
+            if (!door )
+            {
+                sLog.outError("SCRIPT_COMMAND_OPEN_DOOR failed for gameobject(guid: %u).", step.script->datalong);
                 break;
             }
-            case SCRIPT_COMMAND_CLOSE_DOOR:
+            if (door->GetGoType() != GAMEOBJECT_TYPE_DOOR )
             {
-                if (!step.script->datalong)                  // guid for door not specified
-                {
-                    sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for NULL door.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_OPEN_DOOR failed for non-door(GoType: %u).", door->GetGoType());
+                break;
+            }
 
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for NULL unit.");
-                    break;
-                }
+            if (!door->GetGoState() )
+                break;                                  //door already  open
 
-                if (!source->isType(TYPEMASK_UNIT))          // must be any Unit (creature or player)
-                {
-                    sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for non-unit (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            door->UseDoorOrButton(time_to_close);
 
-                Unit* caster = (Unit*)source;
+            if (target && target->isType(TYPEMASK_GAMEOBJECT) && ((GameObject*)target)->GetGoType()==GAMEOBJECT_TYPE_BUTTON)
+                ((GameObject*)target)->UseDoorOrButton(time_to_close);
+            break;
+        }
+        case SCRIPT_COMMAND_CLOSE_DOOR:
+        {
+            if (!step.script->datalong)                  // guid for door not specified
+            {
+                sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for NULL door.");
+                break;
+            }
 
-                GameObject *door = NULL;
-                int32 time_to_open = step.script->datalong2 < 15 ? 15 : (int32)step.script->datalong2;
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for NULL unit.");
+                break;
+            }
 
-                CellPair p(Neo::ComputeCellPair(caster->GetPositionX(), caster->GetPositionY()));
-                Cell cell(p);
-                cell.data.Part.reserved = ALL_DISTRICT;
+            if (!source->isType(TYPEMASK_UNIT))          // must be any Unit (creature or player)
+            {
+                sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR call for non-unit (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                Neo::GameObjectWithDbGUIDCheck go_check(*caster,step.script->datalong);
-                Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(door,go_check);
+            Unit* caster = (Unit*)source;
 
-                TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
-                CellLock<GridReadGuard> cell_lock(cell, p);
-                cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(caster->GetMapId(), (Unit*)source));
+            GameObject *door = NULL;
+            int32 time_to_open = step.script->datalong2 < 15 ? 15 : (int32)step.script->datalong2;
 
-                if (!door )
-                {
-                    sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR failed for gameobject(guid: %u).", step.script->datalong);
-                    break;
-                }
-                if (door->GetGoType() != GAMEOBJECT_TYPE_DOOR )
-                {
-                    sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR failed for non-door(GoType: %u).", door->GetGoType());
-                    break;
-                }
+            CellPair p(Neo::ComputeCellPair(caster->GetPositionX(), caster->GetPositionY()));
+            Cell cell(p);
+            cell.data.Part.reserved = ALL_DISTRICT;
 
-                if (door->GetGoState() )
-                    break;                                  //door already closed
+            Neo::GameObjectWithDbGUIDCheck go_check(*caster,step.script->datalong);
+            Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck> checker(door,go_check);
 
-                door->UseDoorOrButton(time_to_open);
-
-                if (target && target->isType(TYPEMASK_GAMEOBJECT) && ((GameObject*)target)->GetGoType()==GAMEOBJECT_TYPE_BUTTON)
-                    ((GameObject*)target)->UseDoorOrButton(time_to_open);
+            TypeContainerVisitor<Neo::GameObjectSearcher<Neo::GameObjectWithDbGUIDCheck>, GridTypeMapContainer > object_checker(checker);
+            CellLock<GridReadGuard> cell_lock(cell, p);
+            cell_lock->Visit(cell_lock, object_checker, *MapManager::Instance().GetMap(caster->GetMapId(), (Unit*)source));
 
+            if (!door )
+            {
+                sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR failed for gameobject(guid: %u).", step.script->datalong);
                 break;
             }
-            case SCRIPT_COMMAND_QUEST_EXPLORED:
+            if (door->GetGoType() != GAMEOBJECT_TYPE_DOOR )
             {
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for NULL source.");
-                    break;
-                }
-
-                if (!target)
-                {
-                    sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for NULL target.");
-                    break;
-                }
-
-                // when script called for item spell casting then target == (unit or GO) and source is player
-                WorldObject* worldObject;
-                Player* player;
-
-                if (target->GetTypeId()==TYPEID_PLAYER)
-                {
-                    if (source->GetTypeId()!=TYPEID_UNIT && source->GetTypeId()!=TYPEID_GAMEOBJECT)
-                    {
-                        sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-creature and non-gameobject (TypeId: %u), skipping.",source->GetTypeId());
-                        break;
-                    }
+                sLog.outError("SCRIPT_COMMAND_CLOSE_DOOR failed for non-door(GoType: %u).", door->GetGoType());
+                break;
+            }
 
-                    worldObject = (WorldObject*)source;
-                    player = target->ToPlayer();
-                }
-                else
-                {
-                    if (target->GetTypeId()!=TYPEID_UNIT && target->GetTypeId()!=TYPEID_GAMEOBJECT)
-                    {
-                        sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-creature and non-gameobject (TypeId: %u), skipping.",target->GetTypeId());
-                        break;
-                    }
+            if (door->GetGoState() )
+                break;                                  //door already closed
 
-                    if (source->GetTypeId()!=TYPEID_PLAYER)
-                    {
-                        sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-player(TypeId: %u), skipping.",source->GetTypeId());
-                        break;
-                    }
+            door->UseDoorOrButton(time_to_open);
 
-                    worldObject = (WorldObject*)target;
-                    player = source->ToPlayer();
-                }
+            if (target && target->isType(TYPEMASK_GAMEOBJECT) && ((GameObject*)target)->GetGoType()==GAMEOBJECT_TYPE_BUTTON)
+                ((GameObject*)target)->UseDoorOrButton(time_to_open);
 
-                // quest id and flags checked at script loading
-                if ((worldObject->GetTypeId()!=TYPEID_UNIT || ((Unit*)worldObject)->isAlive()) &&
-                    (step.script->datalong2==0 || worldObject->IsWithinDistInMap(player,float(step.script->datalong2))) )
-                    player->AreaExploredOrEventHappens(step.script->datalong);
-                else
-                    player->FailQuest(step.script->datalong);
+            break;
+        }
+        case SCRIPT_COMMAND_QUEST_EXPLORED:
+        {
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for NULL source.");
+                break;
+            }
 
+            if (!target)
+            {
+                sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for NULL target.");
                 break;
             }
 
-            case SCRIPT_COMMAND_ACTIVATE_OBJECT:
+            // when script called for item spell casting then target == (unit or GO) and source is player
+            WorldObject* worldObject;
+            Player* player;
+
+            if (target->GetTypeId()==TYPEID_PLAYER)
             {
-                if (!source)
+                if (source->GetTypeId()!=TYPEID_UNIT && source->GetTypeId()!=TYPEID_GAMEOBJECT)
                 {
-                    sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT must have source caster.");
+                    sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-creature and non-gameobject (TypeId: %u), skipping.",source->GetTypeId());
                     break;
                 }
 
-                if (!source->isType(TYPEMASK_UNIT))
+                worldObject = (WorldObject*)source;
+                player = target->ToPlayer();
+            }
+            else
+            {
+                if (target->GetTypeId()!=TYPEID_UNIT && target->GetTypeId()!=TYPEID_GAMEOBJECT)
                 {
-                    sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT source caster isn't unit (TypeId: %u), skipping.",source->GetTypeId());
+                    sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-creature and non-gameobject (TypeId: %u), skipping.",target->GetTypeId());
                     break;
                 }
 
-                if (!target)
+                if (source->GetTypeId()!=TYPEID_PLAYER)
                 {
-                    sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT call for NULL gameobject.");
+                    sLog.outError("SCRIPT_COMMAND_QUEST_EXPLORED call for non-player(TypeId: %u), skipping.",source->GetTypeId());
                     break;
                 }
 
-                if (target->GetTypeId()!=TYPEID_GAMEOBJECT)
-                {
-                    sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT call for non-gameobject (TypeId: %u), skipping.",target->GetTypeId());
-                    break;
-                }
+                worldObject = (WorldObject*)target;
+                player = source->ToPlayer();
+            }
 
-                Unit* caster = (Unit*)source;
+            // quest id and flags checked at script loading
+            if ((worldObject->GetTypeId()!=TYPEID_UNIT || ((Unit*)worldObject)->isAlive()) &&
+                (step.script->datalong2==0 || worldObject->IsWithinDistInMap(player,float(step.script->datalong2))) )
+                player->AreaExploredOrEventHappens(step.script->datalong);
+            else
+                player->FailQuest(step.script->datalong);
 
-                GameObject *go = (GameObject*)target;
+            break;
+        }
 
-                go->Use(caster);
+        case SCRIPT_COMMAND_ACTIVATE_OBJECT:
+        {
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT must have source caster.");
                 break;
             }
 
-            case SCRIPT_COMMAND_REMOVE_AURA:
+            if (!source->isType(TYPEMASK_UNIT))
             {
-                Object* cmdTarget = step.script->datalong2 ? source : target;
-
-                if (!cmdTarget)
-                {
-                    sLog.outError("SCRIPT_COMMAND_REMOVE_AURA call for NULL %s.",step.script->datalong2 ? "source" : "target");
-                    break;
-                }
-
-                if (!cmdTarget->isType(TYPEMASK_UNIT))
-                {
-                    sLog.outError("SCRIPT_COMMAND_REMOVE_AURA %s isn't unit (TypeId: %u), skipping.",step.script->datalong2 ? "source" : "target",cmdTarget->GetTypeId());
-                    break;
-                }
-
-                ((Unit*)cmdTarget)->RemoveAurasDueToSpell(step.script->datalong);
+                sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT source caster isn't unit (TypeId: %u), skipping.",source->GetTypeId());
                 break;
             }
 
-            case SCRIPT_COMMAND_CAST_SPELL:
+            if (!target)
             {
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_CAST_SPELL must have source caster.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT call for NULL gameobject.");
+                break;
+            }
 
-                if (!source->isType(TYPEMASK_UNIT))
-                {
-                    sLog.outError("SCRIPT_COMMAND_CAST_SPELL source caster isn't unit (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            if (target->GetTypeId()!=TYPEID_GAMEOBJECT)
+            {
+                sLog.outError("SCRIPT_COMMAND_ACTIVATE_OBJECT call for non-gameobject (TypeId: %u), skipping.",target->GetTypeId());
+                break;
+            }
 
-                Object* cmdTarget = step.script->datalong2 ? source : target;
+            Unit* caster = (Unit*)source;
 
-                if (!cmdTarget)
-                {
-                    sLog.outError("SCRIPT_COMMAND_CAST_SPELL call for NULL %s.",step.script->datalong2 ? "source" : "target");
-                    break;
-                }
+            GameObject *go = (GameObject*)target;
 
-                if (!cmdTarget->isType(TYPEMASK_UNIT))
-                {
-                    sLog.outError("SCRIPT_COMMAND_CAST_SPELL %s isn't unit (TypeId: %u), skipping.",step.script->datalong2 ? "source" : "target",cmdTarget->GetTypeId());
-                    break;
-                }
+            go->Use(caster);
+            break;
+        }
 
-                Unit* spellTarget = (Unit*)cmdTarget;
+        case SCRIPT_COMMAND_REMOVE_AURA:
+        {
+            Object* cmdTarget = step.script->datalong2 ? source : target;
 
-                //TODO: when GO cast implemented, code below must be updated accordingly to also allow GO spell cast
-                ((Unit*)source)->CastSpell(spellTarget,step.script->datalong,false);
+            if (!cmdTarget)
+            {
+                sLog.outError("SCRIPT_COMMAND_REMOVE_AURA call for NULL %s.",step.script->datalong2 ? "source" : "target");
+                break;
+            }
 
+            if (!cmdTarget->isType(TYPEMASK_UNIT))
+            {
+                sLog.outError("SCRIPT_COMMAND_REMOVE_AURA %s isn't unit (TypeId: %u), skipping.",step.script->datalong2 ? "source" : "target",cmdTarget->GetTypeId());
                 break;
             }
 
-            case SCRIPT_COMMAND_LOAD_PATH:
+            ((Unit*)cmdTarget)->RemoveAurasDueToSpell(step.script->datalong);
+            break;
+        }
+
+        case SCRIPT_COMMAND_CAST_SPELL:
+        {
+            if (!source)
             {
-                if (!source)
-                {
-                    sLog.outError("SCRIPT_COMMAND_START_MOVE is tried to apply to NON-existing unit.");
-                    break;
-                }
+                sLog.outError("SCRIPT_COMMAND_CAST_SPELL must have source caster.");
+                break;
+            }
 
-                if (!source->isType(TYPEMASK_UNIT))
-                {
-                    sLog.outError("SCRIPT_COMMAND_START_MOVE source mover isn't unit (TypeId: %u), skipping.",source->GetTypeId());
-                    break;
-                }
+            if (!source->isType(TYPEMASK_UNIT))
+            {
+                sLog.outError("SCRIPT_COMMAND_CAST_SPELL source caster isn't unit (TypeId: %u), skipping.",source->GetTypeId());
+                break;
+            }
 
-                if (!sWaypointMgr->GetPath(step.script->datalong))
-                {
-                    sLog.outError("SCRIPT_COMMAND_START_MOVE source mover has an invallid path, skipping.", step.script->datalong2);
-                    break;
-                }
+            Object* cmdTarget = step.script->datalong2 ? source : target;
 
-                dynamic_cast<Unit*>(source)->GetMotionMaster()->MovePath(step.script->datalong, step.script->datalong2);
+            if (!cmdTarget)
+            {
+                sLog.outError("SCRIPT_COMMAND_CAST_SPELL call for NULL %s.",step.script->datalong2 ? "source" : "target");
                 break;
             }
 
-            case SCRIPT_COMMAND_CALLSCRIPT_TO_UNIT:
+            if (!cmdTarget->isType(TYPEMASK_UNIT))
             {
-                if (!step.script->datalong || !step.script->datalong2)
-                {
-                    sLog.outError("SCRIPT_COMMAND_CALLSCRIPT calls invallid db_script_id or lowguid not present: skipping.");
-                    break;
-                }
-                //our target
-                Creature* target = NULL;
+                sLog.outError("SCRIPT_COMMAND_CAST_SPELL %s isn't unit (TypeId: %u), skipping.",step.script->datalong2 ? "source" : "target",cmdTarget->GetTypeId());
+                break;
+            }
 
-                if (source) //using grid searcher
-                {
-                    CellPair p(Neo::ComputeCellPair(((Unit*)source)->GetPositionX(), ((Unit*)source)->GetPositionY()));
-                    Cell cell(p);
-                    cell.data.Part.reserved = ALL_DISTRICT;
+            Unit* spellTarget = (Unit*)cmdTarget;
 
-                    //sLog.outDebug("Attempting to find Creature: Db GUID: %i", step.script->datalong);
-                    Neo::CreatureWithDbGUIDCheck target_check(((Unit*)source), step.script->datalong);
-                    Neo::CreatureSearcher<Neo::CreatureWithDbGUIDCheck> checker(target,target_check);
+            //TODO: when GO cast implemented, code below must be updated accordingly to also allow GO spell cast
+            ((Unit*)source)->CastSpell(spellTarget,step.script->datalong,false);
 
-                    TypeContainerVisitor<Neo::CreatureSearcher <Neo::CreatureWithDbGUIDCheck>, GridTypeMapContainer > unit_checker(checker);
-                    CellLock<GridReadGuard> cell_lock(cell, p);
-                    cell_lock->Visit(cell_lock, unit_checker, *(((Unit*)source)->GetMap()));
-                }
-                else //check hashmap holders
-                {
-                    if (CreatureData const* data = objmgr.GetCreatureData(step.script->datalong))
-                        target = ObjectAccessor::GetObjectInWorld<Creature>(data->mapid, data->posX, data->posY, MAKE_NEW_GUID(step.script->datalong, data->id, HIGHGUID_UNIT), target);
-                }
-                //sLog.outDebug("attempting to pass target...");
-                if (!target)
-                    break;
-                //sLog.outDebug("target passed");
-                //Lets choose our ScriptMap map
-                ScriptMapMap *datamap = NULL;
-                switch(step.script->dataint)
-                {
-                    case 1://QUEST END SCRIPTMAP
-                        datamap = &sQuestEndScripts;
-                        break;
-                    case 2://QUEST START SCRIPTMAP
-                        datamap = &sQuestStartScripts;
-                        break;
-                    case 3://SPELLS SCRIPTMAP
-                        datamap = &sSpellScripts;
-                        break;
-                    case 4://GAMEOBJECTS SCRIPTMAP
-                        datamap = &sGameObjectScripts;
-                        break;
-                    case 5://EVENTS SCRIPTMAP
-                        datamap = &sEventScripts;
-                        break;
-                    case 6://WAYPOINTS SCRIPTMAP
-                        datamap = &sWaypointScripts;
-                        break;
-                    default:
-                        sLog.outError("SCRIPT_COMMAND_CALLSCRIPT ERROR: no scriptmap present... ignoring");
-                        break;
-                }
-                //if no scriptmap present...
-                if (!datamap)
-                    break;
+            break;
+        }
 
-                uint32 script_id = step.script->datalong2;
-                //insert script into schedule but do not start it
-                ScriptsStart(*datamap, script_id, target, NULL, false);
+        case SCRIPT_COMMAND_LOAD_PATH:
+        {
+            if (!source)
+            {
+                sLog.outError("SCRIPT_COMMAND_START_MOVE is tried to apply to NON-existing unit.");
                 break;
             }
 
-            case SCRIPT_COMMAND_PLAYSOUND:
+            if (!source->isType(TYPEMASK_UNIT))
             {
-                if (!source)
-                    break;
-                //datalong sound_id, datalong2 onlyself
-                ((WorldObject*)source)->SendPlaySound(step.script->datalong, step.script->datalong2);
+                sLog.outError("SCRIPT_COMMAND_START_MOVE source mover isn't unit (TypeId: %u), skipping.",source->GetTypeId());
                 break;
             }
 
-            case SCRIPT_COMMAND_KILL:
+            if (!sWaypointMgr->GetPath(step.script->datalong))
             {
-                if (!source || source->ToCreature()->isDead())
-                    break;
+                sLog.outError("SCRIPT_COMMAND_START_MOVE source mover has an invallid path, skipping.", step.script->datalong2);
+                break;
+            }
+
+            dynamic_cast<Unit*>(source)->GetMotionMaster()->MovePath(step.script->datalong, step.script->datalong2);
+            break;
+        }
 
-                source->ToCreature()->DealDamage(source->ToCreature(), source->ToCreature()->GetHealth(), NULL, DIRECT_DAMAGE, SPELL_SCHOOL_MASK_NORMAL, NULL, false);
+        case SCRIPT_COMMAND_CALLSCRIPT_TO_UNIT:
+        {
+            if (!step.script->datalong || !step.script->datalong2)
+            {
+                sLog.outError("SCRIPT_COMMAND_CALLSCRIPT calls invallid db_script_id or lowguid not present: skipping.");
+                break;
+            }
+            //our target
+            Creature* target = NULL;
 
-                switch(step.script->dataint)
-                {
-                case 0: break; //return false not remove corpse
-                case 1: source->ToCreature()->RemoveCorpse(); break;
-                }
+            if (source) //using grid searcher
+            {
+                CellPair p(Neo::ComputeCellPair(((Unit*)source)->GetPositionX(), ((Unit*)source)->GetPositionY()));
+                Cell cell(p);
+                cell.data.Part.reserved = ALL_DISTRICT;
+
+                //sLog.outDebug("Attempting to find Creature: Db GUID: %i", step.script->datalong);
+                Neo::CreatureWithDbGUIDCheck target_check(((Unit*)source), step.script->datalong);
+                Neo::CreatureSearcher<Neo::CreatureWithDbGUIDCheck> checker(target,target_check);
+
+                TypeContainerVisitor<Neo::CreatureSearcher <Neo::CreatureWithDbGUIDCheck>, GridTypeMapContainer > unit_checker(checker);
+                CellLock<GridReadGuard> cell_lock(cell, p);
+                cell_lock->Visit(cell_lock, unit_checker, *(((Unit*)source)->GetMap()));
+            }
+            else //check hashmap holders
+            {
+                if (CreatureData const* data = objmgr.GetCreatureData(step.script->datalong))
+                    target = ObjectAccessor::GetObjectInWorld<Creature>(data->mapid, data->posX, data->posY, MAKE_NEW_GUID(step.script->datalong, data->id, HIGHGUID_UNIT), target);
+            }
+            //sLog.outDebug("attempting to pass target...");
+            if (!target)
                 break;
+            //sLog.outDebug("target passed");
+            //Lets choose our ScriptMap map
+            ScriptMapMap *datamap = NULL;
+            switch(step.script->dataint)
+            {
+                case 1://QUEST END SCRIPTMAP
+                    datamap = &sQuestEndScripts;
+                    break;
+                case 2://QUEST START SCRIPTMAP
+                    datamap = &sQuestStartScripts;
+                    break;
+                case 3://SPELLS SCRIPTMAP
+                    datamap = &sSpellScripts;
+                    break;
+                case 4://GAMEOBJECTS SCRIPTMAP
+                    datamap = &sGameObjectScripts;
+                    break;
+                case 5://EVENTS SCRIPTMAP
+                    datamap = &sEventScripts;
+                    break;
+                case 6://WAYPOINTS SCRIPTMAP
+                    datamap = &sWaypointScripts;
+                    break;
+                default:
+                    sLog.outError("SCRIPT_COMMAND_CALLSCRIPT ERROR: no scriptmap present... ignoring");
+                    break;
             }
+            //if no scriptmap present...
+            if (!datamap)
+                break;
 
-            default:
-                sLog.outError("Unknown script command %u called.",step.script->command);
+            uint32 script_id = step.script->datalong2;
+            //insert script into schedule but do not start it
+            ScriptsStart(*datamap, script_id, target, NULL);
+            break;
+        }
+
+        case SCRIPT_COMMAND_PLAYSOUND:
+        {
+            if (!source)
                 break;
+            //datalong sound_id, datalong2 onlyself
+            ((WorldObject*)source)->SendPlaySound(step.script->datalong, step.script->datalong2);
+            break;
         }
 
-        m_scriptSchedule.erase(iter);
+        case SCRIPT_COMMAND_KILL:
+        {
+            if (!source || source->ToCreature()->isDead())
+                break;
+
+            source->ToCreature()->DealDamage(source->ToCreature(), source->ToCreature()->GetHealth(), NULL, DIRECT_DAMAGE, SPELL_SCHOOL_MASK_NORMAL, NULL, false);
 
-        iter = m_scriptSchedule.begin();
+            switch(step.script->dataint)
+            {
+            case 0: break; //return false not remove corpse
+            case 1: source->ToCreature()->RemoveCorpse(); break;
+            }
+            break;
+        }
+
+        default:
+            sLog.outError("Unknown script command %u called.",step.script->command);
+            break;
     }
-    return;
 }
 
 /// Send a packet to all players (except self if mentioned)
@@ -3342,6 +3430,68 @@ void World::UpdateSessions(time_t diff )
     }
 }
 
+/// Save players whose autosave timer expired, at most PlayerSave.MaxPerTick per world update
+void World::ProcessAutoSaves()
+{
+    // players queued by the map threads during MapManager::Update
+    std::vector<uint64> incoming;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_autoSaveIncomingLock);
+        incoming.swap(m_autoSaveIncoming);
+    }
+
+    for (std::vector<uint64>::const_iterator itr = incoming.begin(); itr != incoming.end(); ++itr)
+    {
+        Player* player = ObjectAccessor::FindPlayer(*itr);
+        if (!player || !player->IsAutoSaveQueued())
+            continue;
+
+        // a player queued again for significant changes stays in the plain queue too, that entry is dropped when reached
+        if (player->HasSignificantChanges())
+            m_autoSaveSignificantQueue.push_back(*itr);
+        else
+            m_autoSaveQueue.push_back(*itr);
+    }
+
+    if (m_autoSaveQueue.empty() && m_autoSaveSignificantQueue.empty())
+        return;
+
+    uint32 budget = m_configs[CONFIG_INTERVAL_SAVE_MAX_PER_TICK];
+    if (!budget)
+        budget = m_autoSaveQueue.size() + m_autoSaveSignificantQueue.size();
+
+    // the character db writer is behind, only players with looted items or changed money are saved now
+    bool dbBusy = m_configs[CONFIG_INTERVAL_SAVE_MAX_DB_QUEUE] &&
+        CharacterDatabase.GetDelayQueueSize() > m_configs[CONFIG_INTERVAL_SAVE_MAX_DB_QUEUE];
+
+    // only the front of each queue is looked at, every stale entry is dropped once
+    AutoSaveQueue* queues[2] = { &m_autoSaveSignificantQueue, &m_autoSaveQueue };
+    for (int i = 0; i < 2 && budget; ++i)
+    {
+        if (i == 1 && dbBusy)
+            break;
+
+        AutoSaveQueue& queue = *queues[i];
+        while (!queue.empty() && budget)
+        {
+            uint64 guid = queue.front();
+            queue.pop_front();
+
+            // logged out or already saved by other code since it was queued
+            Player* player = ObjectAccessor::FindPlayer(guid);
+            if (!player || !player->IsAutoSaveQueued())
+                continue;
+
+            player->SaveToDB();
+            sLog.outDetail("Player '%s' (GUID: %u) saved", player->GetName(), player->GetGUIDLow());
+            ++m_autoSaveCount;
+            --budget;
+        }
+    }
+
+    m_autoSaveDeferred += m_autoSaveQueue.size() + m_autoSaveSignificantQueue.size();
+}
+
 // This handles the issued and queued CLI commands
 void World::ProcessCliCommands()
 {
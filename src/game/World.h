@@ -30,6 +30,9 @@
 #include "Policies/Singleton.h"
 #include "SharedDefines.h"
 #include "Database/QueryResult.h"
+#include "ScriptAction.h"
+#include "ace/Atomic_Op.h"
+#include "ace/Thread_Mutex.h"
 
 #include <map>
 #include <set>
@@ -40,7 +43,7 @@ class WorldPacket;
 class WorldSession;
 class Player;
 class Weather;
-struct ScriptAction;
+class Map;
 struct ScriptInfo;
 class SqlResultQueue;
 class QueryResult;
@@ -101,8 +104,13 @@ enum WorldConfigs
     CONFIG_GRID_UNLOAD,
     CONFIG_DUEL_SYSTEM,
     CONFIG_INTERVAL_SAVE,
+    CONFIG_INTERVAL_SAVE_MAX_PER_TICK,
+    CONFIG_INTERVAL_SAVE_MAX_DB_QUEUE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
+    CONFIG_GRID_PRELOAD_DISTANCE,
+    CONFIG_GRID_PRELOAD_PER_TICK,
+    CONFIG_RANDOM_SEED,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
     CONFIG_PORT_WORLD,
@@ -239,6 +247,7 @@ enum WorldConfigs
     CONFIG_PET_LOS,
     CONFIG_VMAP_TOTEM,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_PACKETS,
     CONFIG_CHATLOG_CHANNEL,
     CONFIG_CHATLOG_WHISPER,
     CONFIG_CHATLOG_SYSCHAN,
@@ -522,6 +531,24 @@ class World
         uint32 GetUpdateTime() const { return m_updateTime; }
         void SetRecordDiffInterval(int32 t) { if (t >= 0) m_configs[CONFIG_INTERVAL_LOG_UPDATE] = (uint32)t; }
 
+        /// Queue a player whose autosave timer expired, saved by ProcessAutoSaves within the per tick budget
+        /// called from the map update threads, also again when a queued player gets significant changes
+        void ScheduleAutoSave(uint64 guid)
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_autoSaveIncomingLock);
+            m_autoSaveIncoming.push_back(guid);
+        }
+        uint32 GetAutoSaveQueueSize() const { return m_autoSaveQueue.size() + m_autoSaveSignificantQueue.size(); }
+        uint32 GetAutoSaveCount() const { return m_autoSaveCount; }
+        uint32 GetAutoSaveDeferredCount() const { return m_autoSaveDeferred; }
+
+        /// Where PROCESS_MAP packets ran, and how often a map left a world packet waiting for the next tick
+        void AddMapPacketsInMap(uint32 count, uint32 deferred) { m_mapPacketsInMap += count; m_worldPacketsDeferred += deferred; }
+        void AddMapPacketsInWorld(uint32 count) { m_mapPacketsInWorld += count; }
+        uint32 GetMapPacketsInMap() const { return uint32(m_mapPacketsInMap.value()); }
+        uint32 GetMapPacketsInWorld() const { return m_mapPacketsInWorld; }
+        uint32 GetWorldPacketsDeferred() const { return uint32(m_worldPacketsDeferred.value()); }
+
         /// Get the maximum skill level a player can reach
         uint16 GetConfigMaxSkillValue() const
         {
@@ -584,9 +611,12 @@ class World
         BanReturn BanAccount(BanMode mode, std::string nameOrIP, std::string duration, std::string reason, std::string author);
         bool RemoveBanAccount(BanMode mode, std::string nameOrIP);
 
-        void ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo> > const& scripts, uint32 id, Object* source, Object* target, bool start = true);
+        // only queue the steps, due ones run in the next update of the source's map or of the world
+        void ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo> > const& scripts, uint32 id, Object* source, Object* target);
         void ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target);
-        bool IsScriptScheduled() const { return !m_scriptSchedule.empty(); }
+        bool IsScriptScheduled() const { return m_scheduledScripts.value() != 0; }
+        void ScriptActionDone(long count = 1) { m_scheduledScripts -= count; }
+        void ScriptActionExecute(ScriptAction const& step, Map* map);
 
         bool IsAllowedMap(uint32 mapid) { return m_forbiddenMapIds.count(mapid) == 0 ;}
 
@@ -649,6 +679,7 @@ class World
 	protected:
         void _UpdateGameTime();
         void ScriptsProcess();
+        void ScriptActionSchedule(Map* map, time_t when, ScriptAction const& sa);
         // callback for UpdateRealmCharacters
         void _UpdateRealmCharCount(QueryResult_AutoPtr resultCharCount, uint32 accountId);
 
@@ -670,6 +701,19 @@ class World
         uint32 m_updateTimeCount;
         uint32 m_currentTime;
 
+        void ProcessAutoSaves();
+        typedef std::list<uint64> AutoSaveQueue;
+        std::vector<uint64> m_autoSaveIncoming;             // filled by the map threads, sorted into the queues below
+        ACE_Thread_Mutex m_autoSaveIncomingLock;
+        AutoSaveQueue m_autoSaveSignificantQueue;           // looted items or changed money, saved first
+        AutoSaveQueue m_autoSaveQueue;
+        uint32 m_autoSaveCount;                             // autosaves done since startup
+        uint32 m_autoSaveDeferred;                          // ticks a due autosave had to wait for budget
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_mapPacketsInMap;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_worldPacketsDeferred;
+        uint32 m_mapPacketsInWorld;                         // world thread only
+
         uint64 m_server_lockdown_time;
         bool m_locked_down;
         bool m_maintenance_done;
@@ -683,7 +727,11 @@ class World
         uint32 m_maxActiveSessionCount;
         uint32 m_maxQueuedSessionCount;
 
-        std::multimap<time_t, ScriptAction> m_scriptSchedule;
+        // actions of sources outside of any map, executed on the world thread
+        ScriptSchedule m_scriptSchedule;
+        ACE_Thread_Mutex m_scriptScheduleLock;
+        // queued actions in all maps, script tables can't be reloaded before it drops to zero
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_scheduledScripts;
 
         std::string m_newCharString;
 
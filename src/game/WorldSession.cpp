@@ -25,6 +25,7 @@
 #include "WorldSocket.h"                                    // must be first to make ACE happy with ACE includes in it
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/DatabaseImpl.h"
 #include "Log.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
@@ -48,7 +49,8 @@ WorldSession::WorldSession(uint32 id, WorldSocket *sock, uint32 sec, uint8 expan
 LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mute_time),
 _player(NULL), m_Socket(sock),_security(sec), _accountId(id), m_expansion(expansion),
 m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(objmgr.GetIndexForLocale(locale)),
-_logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_latency(0)
+_logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_latency(0),
+m_pendingQueries(0)
 {
     if (sock)
     {
@@ -96,10 +98,78 @@ WorldSession::~WorldSession()
     WorldPacket* packet;
     while (_recvQueue.next(packet))
         delete packet;
+
+    ///- drop handler continuations that did not get to run
+    for (PendingQueryQueue::iterator itr = m_queryResults.begin(); itr != m_queryResults.end(); ++itr)
+        delete *itr;
+
     LoginDatabase.PExecute("UPDATE account SET active_realm_id = 0 WHERE id = '%u'", GetAccountId());
     CharacterDatabase.PExecute("UPDATE characters SET online = 0 WHERE account = %u;", GetAccountId());
 }
 
+bool WorldSession::AsyncPQuery(QueryContinuation method, uint64 param, const char *format,...)
+{
+    if (!format)
+        return false;
+
+    char szQuery [MAX_QUERY_LEN];
+    va_list ap;
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return false;
+    }
+
+    PendingQuery* query = new PendingQuery;
+    query->session = this;
+    query->playerGuid = _player ? _player->GetGUID() : 0;
+    query->method = method;
+    query->param = param;
+
+    if (!CharacterDatabase.AsyncQuery(&WorldSession::QueryContinuationCallBack, GetAccountId(), query, szQuery))
+    {
+        delete query;
+        return false;
+    }
+
+    ++m_pendingQueries;
+    return true;
+}
+
+// called from World::UpdateResultQueue, the session may be gone or already serve another character
+void WorldSession::QueryContinuationCallBack(QueryResult_AutoPtr result, uint32 accountId, PendingQuery* query)
+{
+    WorldSession* session = sWorld.FindSession(accountId);
+    if (!session || session != query->session || !session->m_pendingQueries)
+    {
+        delete query;
+        return;
+    }
+
+    query->result = result;
+    session->m_queryResults.push_back(query);
+}
+
+void WorldSession::ProcessQueryContinuations()
+{
+    while (!m_queryResults.empty())
+    {
+        PendingQuery* query = m_queryResults.front();
+        m_queryResults.pop_front();
+        --m_pendingQueries;
+
+        uint64 playerGuid = _player ? _player->GetGUID() : 0;
+        if (query->playerGuid == playerGuid)
+            (this->*query->method)(query->result, query->param);
+
+        delete query;
+    }
+}
+
 void WorldSession::SizeError(WorldPacket const& packet, uint32 size) const
 {
     sLog.outError("Client (account %u) send packet %s (%u) with size %u but expected %u (attempt crash server?), skipped",
@@ -185,92 +255,27 @@ void WorldSession::LogUnprocessedTail(WorldPacket *packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 /*diff*/)
 {
+    ///- Resume handlers whose queries have finished
+    ProcessQueryContinuations();
+
     ///- Retrieve packets from the receive queue and call the appropriate handlers
-    /// not proccess packets if socket already closed
+    /// not proccess packets if socket already closed or a handler still waits for its query
+    /// map local packets of a player in world are left to ProcessMapPackets()
     WorldPacket* packet;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet))
+    WorldPacketFilter filter(this);
+    while (m_Socket && !m_Socket->IsClosed() && !m_pendingQueries && _recvQueue.next(packet, filter))
     {
-        /*#if 1
-        sLog.outError("MOEP: %s (0x%.4X)",
-                        LookupOpcodeName(packet->GetOpcode()),
-                        packet->GetOpcode());
-        #endif*/
-
-        if (packet->GetOpcode() >= NUM_MSG_TYPES)
-        {
-            sLog.outError("SESSION: received non-existed opcode %s (0x%.4X)",
-                LookupOpcodeName(packet->GetOpcode()),
-                packet->GetOpcode());
-        }
-        else
-        {
-            OpcodeHandler& opHandle = opcodeTable[packet->GetOpcode()];
-            try
-            {
-                switch (opHandle.status)
-                {
-                    case STATUS_LOGGEDIN:
-                        if (!_player)
-                        {
-                            // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                            if (!m_playerRecentlyLogout)
-                                LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                        }
-                        else if (_player->IsInWorld())
-                        {
-                            (this->*opHandle.handler)(*packet);
-                            if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
-                                LogUnprocessedTail(packet);
-                        }
-                        // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
-                        break;
-                    case STATUS_TRANSFER_PENDING:
-                        if (!_player)
-                            LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                        else if (_player->IsInWorld())
-                            LogUnexpectedOpcode(packet, "the player is still in world");
-                        else
-                        {
-                            (this->*opHandle.handler)(*packet);
-                            if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
-                                LogUnprocessedTail(packet);
-                        }
-                        break;
-                    case STATUS_AUTHED:
-                        // prevent cheating with skip queue wait
-                        if (m_inQueue)
-                        {
-                            LogUnexpectedOpcode(packet, "the player not pass queue yet");
-                            break;
-                        }
-
-                        m_playerRecentlyLogout = false;
-                        (this->*opHandle.handler)(*packet);
-                        if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
-                            LogUnprocessedTail(packet);
-                        break;
-                    case STATUS_NEVER:
-                        sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                            LookupOpcodeName(packet->GetOpcode()),
-                            packet->GetOpcode());
-                        break;
-                }
-            }
-            catch(ByteBufferException &)
-            {
-                sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i. Skipped packet.",
-                        packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
-                if (sLog.IsOutDebug())
-                {
-                    sLog.outDebug("Dumping error causing packet:");
-                    packet->hexlike();
-                }
-             }
-        }
-
+        ExecutePacket(packet);
         delete packet;
     }
 
+    if (filter.mapPackets)
+        sWorld.AddMapPacketsInWorld(filter.mapPackets);
+
+    ///- Falls under the map seen by the movement handlers, in the world thread as the repop leaves the map
+    if (_player && _player->IsFallUnderMapPending())
+        _player->HandleScheduledFallUnderMap();
+
     ///- Cleanup socket pointer if need
     if (m_Socket && m_Socket->IsClosed ())
     {
@@ -289,6 +294,128 @@ bool WorldSession::Update(uint32 /*diff*/)
     return true;
 }
 
+void WorldSession::ProcessMapPackets()
+{
+    // no continuation depends on movement or casts, so these do not wait for pending queries:
+    // holding them would stall the player on his map for a whole DB round trip
+    MapPacketFilter filter;
+    WorldPacket* packet;
+    uint32 count = 0;
+    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, filter))
+    {
+        ExecutePacket(packet);
+        delete packet;
+        ++count;
+    }
+
+    if (count || filter.blocked)
+        sWorld.AddMapPacketsInMap(count, filter.blocked ? 1 : 0);
+}
+
+bool WorldSession::WorldPacketFilter::Process(WorldPacket* packet) const
+{
+    if (!session->_player || !session->_player->IsInWorld() || !sWorld.getConfig(CONFIG_MAP_PACKETS))
+        return true;
+
+    if (packet->GetOpcode() >= NUM_MSG_TYPES || opcodeTable[packet->GetOpcode()].packetProcessing != PROCESS_MAP)
+    {
+        globalHandled = true;
+        return true;
+    }
+
+    // no map is updated while the sessions are, so map packets behind a world packet can run here as well;
+    // leaving them to the map would allow a single world/map switch per tick to a client sending both kinds
+    if (!globalHandled)
+        return false;
+
+    ++mapPackets;
+    return true;
+}
+
+bool WorldSession::MapPacketFilter::Process(WorldPacket* packet) const
+{
+    if (packet->GetOpcode() < NUM_MSG_TYPES && opcodeTable[packet->GetOpcode()].packetProcessing == PROCESS_MAP)
+        return true;
+
+    blocked = true;
+    return false;
+}
+
+void WorldSession::ExecutePacket(WorldPacket* packet)
+{
+    if (packet->GetOpcode() >= NUM_MSG_TYPES)
+    {
+        sLog.outError("SESSION: received non-existed opcode %s (0x%.4X)",
+            LookupOpcodeName(packet->GetOpcode()),
+            packet->GetOpcode());
+    }
+    else
+    {
+        OpcodeHandler& opHandle = opcodeTable[packet->GetOpcode()];
+        try
+        {
+            switch (opHandle.status)
+            {
+                case STATUS_LOGGEDIN:
+                    if (!_player)
+                    {
+                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                        if (!m_playerRecentlyLogout)
+                            LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                    }
+                    else if (_player->IsInWorld())
+                    {
+                        (this->*opHandle.handler)(*packet);
+                        if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
+                            LogUnprocessedTail(packet);
+                    }
+                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+                    break;
+                case STATUS_TRANSFER_PENDING:
+                    if (!_player)
+                        LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                    else if (_player->IsInWorld())
+                        LogUnexpectedOpcode(packet, "the player is still in world");
+                    else
+                    {
+                        (this->*opHandle.handler)(*packet);
+                        if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
+                            LogUnprocessedTail(packet);
+                    }
+                    break;
+                case STATUS_AUTHED:
+                    // prevent cheating with skip queue wait
+                    if (m_inQueue)
+                    {
+                        LogUnexpectedOpcode(packet, "the player not pass queue yet");
+                        break;
+                    }
+
+                    m_playerRecentlyLogout = false;
+                    (this->*opHandle.handler)(*packet);
+                    if (sLog.IsOutDebug() && packet->rpos() < packet->wpos())
+                        LogUnprocessedTail(packet);
+                    break;
+                case STATUS_NEVER:
+                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                        LookupOpcodeName(packet->GetOpcode()),
+                        packet->GetOpcode());
+                    break;
+            }
+        }
+        catch(ByteBufferException &)
+        {
+            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i. Skipped packet.",
+                    packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
+            if (sLog.IsOutDebug())
+            {
+                sLog.outDebug("Dumping error causing packet:");
+                packet->hexlike();
+            }
+         }
+    }
+}
+
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
@@ -405,6 +532,9 @@ void WorldSession::LogoutPlayer(bool Save)
             _player->SaveToDB();
         }
 
+        ///- The mailbox leaves memory with the player, mails sent to him now count against the offline cache
+        objmgr.SetOfflineMailCount(_player->GetGUIDLow(), _player->GetMailSize());
+
         ///- Leave all channels before player delete...
         _player->CleanupChannels();
 
@@ -28,6 +28,8 @@
 #include "Common.h"
 #include "Database/QueryResult.h"
 
+#include <deque>
+
 class MailItemsInfo;
 struct ItemPrototype;
 struct AuctionEntry;
@@ -35,6 +37,7 @@ struct DeclinedName;
 struct MovementInfo;
 
 class Creature;
+class Guild;
 class Item;
 class Object;
 class Player;
@@ -125,6 +128,16 @@ class NEO_DLL_SPEC WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff);
+        /// Handle the queued PROCESS_MAP packets, called from the update of the map the player is on
+        void ProcessMapPackets();
+
+        /// Second half of a handler, called with the result of the query the first half issued
+        typedef void (WorldSession::*QueryContinuation)(QueryResult_AutoPtr result, uint64 param);
+
+        /// Run a character DB query without waiting for it, method resumes the handler at the next session update.
+        /// World thread packets received meanwhile are kept queued, so the client still sees them handled in order;
+        /// PROCESS_MAP packets (movement, casts) do not depend on any continuation and keep running on the map.
+        bool AsyncPQuery(QueryContinuation method, uint64 param, const char *format,...) ATTR_PRINTF(4,5);
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -151,7 +164,9 @@ class NEO_DLL_SPEC WorldSession
         void SendCancelTrade();
 
         void SendStablePet(uint64 guid);
+        void SendStablePetContinuation(QueryResult_AutoPtr result, uint64 guid);
         void SendPetitionQueryOpcode(uint64 petitionguid);
+        void SendPetitionQueryOpcodeContinuation(QueryResult_AutoPtr result, uint64 petitionguid);
         void SendUpdateTrade();
 
         //pet
@@ -366,10 +381,13 @@ class NEO_DLL_SPEC WorldSession
 
         void HandlePetitionBuyOpcode(WorldPacket& recv_data);
         void HandlePetitionShowSignOpcode(WorldPacket& recv_data);
+        void HandlePetitionShowSignContinuation(QueryResult_AutoPtr result, uint64 petitionguid);
         void HandlePetitionQueryOpcode(WorldPacket& recv_data);
         void HandlePetitionRenameOpcode(WorldPacket& recv_data);
         void HandlePetitionSignOpcode(WorldPacket& recv_data);
+        void HandlePetitionSignContinuation(QueryResult_AutoPtr result, uint64 petitionguid);
         void HandlePetitionDeclineOpcode(WorldPacket& recv_data);
+        void HandlePetitionDeclineContinuation(QueryResult_AutoPtr result, uint64 petitionguid);
         void HandleOfferPetitionOpcode(WorldPacket& recv_data);
         void HandleTurnInPetitionOpcode(WorldPacket& recv_data);
 
@@ -381,6 +399,7 @@ class NEO_DLL_SPEC WorldSession
         void HandleGuildDeclineOpcode(WorldPacket& recvPacket);
         void HandleGuildInfoOpcode(WorldPacket& recvPacket);
         void HandleGuildEventLogOpcode(WorldPacket& recvPacket);
+        void HandleGuildEventLogContinuation(QueryResult_AutoPtr result, uint64 GuildId);
         void HandleGuildRosterOpcode(WorldPacket& recvPacket);
         void HandleGuildPromoteOpcode(WorldPacket& recvPacket);
         void HandleGuildDemoteOpcode(WorldPacket& recvPacket);
@@ -634,6 +653,7 @@ class NEO_DLL_SPEC WorldSession
         void HandleGuildBankQuery(WorldPacket& recv_data);
         void HandleGuildBankTabColon(WorldPacket& recv_data);
         void HandleGuildBankLog(WorldPacket& recv_data);
+        void HandleGuildBankLogContinuation(QueryResult_AutoPtr result, uint64 param);
         void HandleGuildBankDeposit(WorldPacket& recv_data);
         void HandleGuildBankWithdraw(WorldPacket& recv_data);
         void HandleGuildBankDepositItem(WorldPacket& recv_data);
@@ -641,6 +661,9 @@ class NEO_DLL_SPEC WorldSession
         void HandleGuildBankBuyTab(WorldPacket& recv_data);
         void HandleGuildBankTabText(WorldPacket& recv_data);
         void HandleGuildBankSetTabText(WorldPacket& recv_data);
+        void SendGuildBankTabsInfo(Guild* pGuild);
+        void SendGuildBankTabsInfoContinuation(QueryResult_AutoPtr result, uint64 GuildId);
+        void SendGuildBankEventLogContinuation(QueryResult_AutoPtr result, uint64 GuildId);
     private:
         // private trade methods
         void moveItems(Item* myItems[], Item* hisItems[]);
@@ -649,6 +672,40 @@ class NEO_DLL_SPEC WorldSession
         void LogUnexpectedOpcode(WorldPacket *packet, const char * reason);
         void LogUnprocessedTail(WorldPacket *packet);
 
+        // calls the handler of a received packet
+        void ExecutePacket(WorldPacket* packet);
+
+        // packets are taken from the receive queue in order, each thread stops at the first one it must not handle
+        // except that the world thread also takes map packets queued behind a world packet it handled
+        struct WorldPacketFilter
+        {
+            explicit WorldPacketFilter(WorldSession* _session) : session(_session), globalHandled(false), mapPackets(0) {}
+            bool Process(WorldPacket* packet) const;
+            WorldSession* session;
+            mutable bool globalHandled;
+            mutable uint32 mapPackets;                      // PROCESS_MAP packets taken in the world thread
+        };
+        struct MapPacketFilter
+        {
+            MapPacketFilter() : blocked(false) {}
+            bool Process(WorldPacket* packet) const;
+            mutable bool blocked;                           // stopped at a world packet, it waits for the next session update
+        };
+
+        // handler continuations
+        struct PendingQuery
+        {
+            WorldSession* session;
+            uint64 playerGuid;                              // player the handler ran for, 0 before login
+            QueryContinuation method;
+            uint64 param;
+            QueryResult_AutoPtr result;
+        };
+        typedef std::deque<PendingQuery*> PendingQueryQueue;
+
+        static void QueryContinuationCallBack(QueryResult_AutoPtr result, uint32 accountId, PendingQuery* query);
+        void ProcessQueryContinuations();
+
         Player *_player;
         WorldSocket *m_Socket;
         std::string m_Address;
@@ -670,6 +727,9 @@ class NEO_DLL_SPEC WorldSession
 		uint32 recruitedId;
 		
         ACE_Based::LockedQueue<WorldPacket*,ACE_Thread_Mutex> _recvQueue;
+
+        PendingQueryQueue m_queryResults;                   // results ready to resume, world thread only
+        uint32 m_pendingQueries;                            // issued and not yet resumed, world thread packets wait while non zero
 };
 #endif
 /// @}
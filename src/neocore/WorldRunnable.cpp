@@ -84,6 +84,7 @@ void WorldRunnable::run()
     sWorldSocketMgr->StopNetwork();
 
     MapManager::Instance().UnloadAll();                     // unload all grids (including locked in memory)
+    MapManager::Instance().HaltGridMapLoader();             // stop reading terrain ahead
 
     ///- End the database thread
     WorldDatabase.ThreadEnd();                                  // free mySQL thread resources
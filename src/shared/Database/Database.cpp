@@ -20,6 +20,7 @@
 
 #include "DatabaseEnv.h"
 #include "Config/ConfigEnv.h"
+#include "Database/SqlDelayThread.h"
 
 #include <ctime>
 #include <iostream>
@@ -44,6 +45,11 @@ bool Database::Initialize(const char *)
     return true;
 }
 
+size_t Database::GetDelayQueueSize() const
+{
+    return m_threadBody ? m_threadBody->GetQueueSize() : 0;
+}
+
 void Database::ThreadStart()
 {
 }
@@ -51,6 +51,7 @@ class NEO_DLL_SPEC Database
         virtual bool Initialize(const char *infoString);
         virtual void InitDelayThread() = 0;
         virtual void HaltDelayThread() = 0;
+        size_t GetDelayQueueSize() const;
 
         virtual QueryResult_AutoPtr Query(const char *sql) = 0;
         QueryResult_AutoPtr PQuery(const char *format,...) ATTR_PRINTF(2,3);
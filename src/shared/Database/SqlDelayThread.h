@@ -43,6 +43,8 @@ class SqlDelayThread : public ACE_Based::Runnable
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql);
+        ///< Number of statements waiting for execution
+        size_t GetQueueSize() const { return m_sqlQueue.method_count(); }
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
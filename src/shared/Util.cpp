@@ -22,60 +22,96 @@
 
 #include "sockets/socket_include.h"
 #include "utf8cpp/utf8.h"
-#include "mersennetwister/MersenneTwister.h"
 #include <ace/TSS_T.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
 
-typedef ACE_TSS<MTRand> MTRandTSS;
-static MTRandTSS mtRand;
+static uint32 randomSeed = 0;
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> randomThreadCount;
 
-int32 irand (int32 min, int32 max)
-{
-    int32 result;
-#pragma omp critical (mtrand)
+static uint64 NewThreadSeed()
 {
-    result = mtRand->randInt (max-min) + min;
-}
-  return result;
+    uint64 thread = uint64(++randomThreadCount);
+    if (randomSeed)
+        return (uint64(randomSeed) << 32) | thread;
+
+    return (uint64(time(NULL)) << 32) ^ uint64(clock()) ^ (thread << 48) ^ uint64(size_t(&thread));
 }
 
-uint32 urand (uint32 min, uint32 max)
+// generators are per thread, so no roll ever needs a lock
+struct ThreadRandom
 {
-    uint32 result;
-#pragma omp critical (mtrand)
+    ThreadRandom() : active(NULL), own(NewThreadSeed()) {}
+
+    RandomGenerator* active;
+    RandomGenerator own;
+};
+
+static ACE_TSS<ThreadRandom> threadRandom;
+
+static inline RandomGenerator& GetGenerator()
 {
-  result =  mtRand->randInt (max - min) + min;
+    ThreadRandom* random = threadRandom;
+    return random->active ? *random->active : random->own;
 }
-  return result;
+
+void SetRandomSeed(uint32 seed)
+{
+    randomSeed = seed;
+    randomThreadCount = 0;
+    threadRandom->own.Seed(NewThreadSeed());
 }
 
-int32 rand32 ()
+uint32 GetRandomSeed()
 {
-   int32 result;
-#pragma omp critical (mtrand)
+    return randomSeed;
+}
+
+RandomGenerator* SetThreadRandomGenerator(RandomGenerator* gen)
 {
-  result =  mtRand->randInt ();
+    ThreadRandom* random = threadRandom;
+    RandomGenerator* prev = random->active;
+    random->active = gen;
+    return prev;
 }
-  return result;
+
+int32 irand (int32 min, int32 max)
+{
+    return int32(GetGenerator().NextInt(uint32(max - min))) + min;
 }
 
-double rand_norm(void)
+uint32 urand (uint32 min, uint32 max)
 {
-  double result;
-#pragma omp critical (mtrand)
+    return GetGenerator().NextInt(max - min) + min;
+}
+
+int32 rand32 ()
 {
-  result = mtRand->randExc ();
+    return int32(GetGenerator().Next());
 }
-  return result;
+
+double rand_norm(void)
+{
+    return GetGenerator().NextDouble();
 }
 
 double rand_chance (void)
 {
-  double result;
-#pragma omp critical (mtrand)
+    return GetGenerator().NextDouble() * 100.0;
+}
+
+void urand_batch(uint32* results, uint32 count, uint32 min, uint32 max)
 {
-  result = mtRand->randExc (100.0);
+    RandomGenerator& gen = GetGenerator();
+    for (uint32 i = 0; i < count; ++i)
+        results[i] = gen.NextInt(max - min) + min;
 }
-  return result;
+
+void rand_chance_batch(double* results, uint32 count)
+{
+    RandomGenerator& gen = GetGenerator();
+    for (uint32 i = 0; i < count; ++i)
+        results[i] = gen.NextDouble() * 100.0;
 }
 
 Tokens StrSplit(const std::string &src, const std::string &sep)
@@ -62,6 +62,87 @@ NEO_DLL_SPEC double rand_norm(void);
  * With an FPU, there is usually no difference in performance between float and double. */
 NEO_DLL_SPEC double rand_chance(void);
 
+/* Fill results with count random numbers in the range min..max (inclusive). */
+NEO_DLL_SPEC void urand_batch(uint32* results, uint32 count, uint32 min, uint32 max);
+
+/* Fill results with count random doubles from 0.0 to 99.9999999999999. */
+NEO_DLL_SPEC void rand_chance_batch(double* results, uint32 count);
+
+/* Small and fast xoshiro128** generator, cheap enough to keep one per thread and per map. */
+class RandomGenerator
+{
+    public:
+        explicit RandomGenerator(uint64 seed = 0) { Seed(seed); }
+
+        void Seed(uint64 seed)
+        {
+            // splitmix64 expansion of the seed into the state
+            for (int i = 0; i < 4; i += 2)
+            {
+                uint64 z = (seed += UI64LIT(0x9E3779B97F4A7C15));
+                z = (z ^ (z >> 30)) * UI64LIT(0xBF58476D1CE4E5B9);
+                z = (z ^ (z >> 27)) * UI64LIT(0x94D049BB133111EB);
+                z ^= z >> 31;
+                m_state[i] = uint32(z);
+                m_state[i+1] = uint32(z >> 32);
+            }
+        }
+
+        // integer in [0,2^32-1]
+        uint32 Next()
+        {
+            uint32 result = Rotl(m_state[1] * 5, 7) * 9;
+            uint32 t = m_state[1] << 9;
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = Rotl(m_state[3], 11);
+            return result;
+        }
+
+        // integer in [0,n]
+        uint32 NextInt(uint32 n) { return uint32((uint64(Next()) * (uint64(n) + 1)) >> 32); }
+
+        // real number in [0,1)
+        double NextDouble() { return double(Next()) * (1.0/4294967296.0); }
+
+    private:
+        static uint32 Rotl(uint32 x, int k) { return (x << k) | (x >> (32 - k)); }
+
+        uint32 m_state[4];
+};
+
+/* Seed for the generators of new threads. 0 (default) seeds them from the clock,
+ * any other value gives every thread and map a reproducible sequence. */
+NEO_DLL_SPEC void SetRandomSeed(uint32 seed);
+NEO_DLL_SPEC uint32 GetRandomSeed();
+
+/* Make the functions above use gen in the calling thread, NULL returns to the thread's own one.
+ * Returns the previously used generator. */
+NEO_DLL_SPEC RandomGenerator* SetThreadRandomGenerator(RandomGenerator* gen);
+
+/* Uses gen in the calling thread while in scope, NULL keeps the current generator. */
+class RandomGeneratorScope
+{
+    public:
+        explicit RandomGeneratorScope(RandomGenerator* gen) : m_set(gen != NULL), m_prev(NULL)
+        {
+            if (m_set)
+                m_prev = SetThreadRandomGenerator(gen);
+        }
+        ~RandomGeneratorScope()
+        {
+            if (m_set)
+                SetThreadRandomGenerator(m_prev);
+        }
+
+    private:
+        bool m_set;
+        RandomGenerator* m_prev;
+};
+
 /* Return true if a random roll fits in the specified chance (range 0-100). */
 inline bool roll_chance_f(float chance)
 {
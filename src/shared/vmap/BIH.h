@@ -32,6 +32,7 @@
 #include <cmath>
 
 #define MAX_STACK_SIZE 64
+#define RAY_PACKET_SIZE 4
 
 #ifdef _MSC_VER
 	#define isnan(x) _isnan(x)
@@ -68,6 +69,77 @@ struct AABound
     Vector3 lo, hi;
 };
 
+/** Group of rays traced together through one BIH traversal.
+    Components are stored per axis (SoA) so the per-lane loops of the
+    packet traversal can be vectorized by the compiler.
+    Unused lanes have to be disabled through the active mask.
+*/
+struct RayPacket
+{
+    RayPacket(): activeMask(0)
+    {
+        // inactive lanes still run through the per-lane loops, keep their values finite
+        for (int i=0; i<3; ++i)
+        {
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+            {
+                org[i][lane] = 0.f;
+                dir[i][lane] = 1.f;
+                invDir[i][lane] = 1.f;
+            }
+        }
+    }
+
+    void setRay(uint32 lane, const Ray &ray)
+    {
+        rays[lane] = ray;
+        for (int i=0; i<3; ++i)
+        {
+            org[i][lane] = ray.origin()[i];
+            dir[i][lane] = ray.direction()[i];
+            invDir[i][lane] = 1.f / dir[i][lane];
+        }
+        activeMask |= 1 << lane;
+    }
+
+    bool isActive(uint32 lane) const { return activeMask & (1 << lane); }
+
+    //! copy of the packet with only the lanes of mask left active
+    RayPacket masked(uint32 mask) const
+    {
+        RayPacket p(*this);
+        p.activeMask &= mask;
+        return p;
+    }
+
+    //! direction sign bits, rays of the same octant always form a coherent packet
+    static uint32 getOctant(const Vector3 &dir)
+    {
+        return (floatToRawIntBits(dir.x) >> 31) | (floatToRawIntBits(dir.y) >> 31) << 1 | (floatToRawIntBits(dir.z) >> 31) << 2;
+    }
+
+    //! true if all active rays share the direction sign on every axis
+    bool isCoherent() const
+    {
+        for (int i=0; i<3; ++i)
+        {
+            uint32 signs = 0;
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                if (isActive(lane))
+                    signs |= 1 << (floatToRawIntBits(dir[i][lane]) >> 31);
+            if (signs == 3)
+                return false;
+        }
+        return true;
+    }
+
+    Ray rays[RAY_PACKET_SIZE];
+    float org[3][RAY_PACKET_SIZE];
+    float dir[3][RAY_PACKET_SIZE];
+    float invDir[3][RAY_PACKET_SIZE];
+    uint32 activeMask;
+};
+
 /** Bounding Interval Hierarchy Class.
     Building and Ray-Intersection functions based on BIH from
     Sunflow, a Java Raytracer, released under MIT/X11 License
@@ -248,6 +320,188 @@ class BIH
             }
         }
 
+        /** Trace up to RAY_PACKET_SIZE rays with one shared traversal stack.
+            The callback tests one object against all lanes of laneMask and returns the mask of lanes that hit:
+            uint32 operator()(const RayPacket &p, uint32 laneMask, uint32 entry, float *maxDist, bool stopAtFirst)
+            Packets whose rays do not share the direction signs are traced ray by ray.
+        */
+        template<typename RayPacketCallback>
+        void intersectRayPacket(const RayPacket &p, RayPacketCallback& intersectCallback, float *maxDist, bool stopAtFirst=false) const
+        {
+            if (!p.activeMask)
+                return;
+
+            if (!p.isCoherent())
+            {
+                for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                {
+                    if (!p.isActive(lane))
+                        continue;
+                    PacketLaneCallback<RayPacketCallback> laneCallback(intersectCallback, p, lane, maxDist);
+                    intersectRay(p.rays[lane], laneCallback, maxDist[lane], stopAtFirst);
+                }
+                return;
+            }
+
+            // a lane is alive as long as its interval is not empty, dead lanes get an empty interval
+            float intervalMin[RAY_PACKET_SIZE];
+            float intervalMax[RAY_PACKET_SIZE];
+            bool done[RAY_PACKET_SIZE];
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+            {
+                intervalMin[lane] = 0.f;
+                intervalMax[lane] = p.isActive(lane) ? maxDist[lane] : -1.f;
+                done[lane] = !p.isActive(lane);
+            }
+            for (int i=0; i<3; ++i)
+            {
+                for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                {
+                    float t1 = (bounds.low()[i] - p.org[i][lane]) * p.invDir[i][lane];
+                    float t2 = (bounds.high()[i] - p.org[i][lane]) * p.invDir[i][lane];
+                    if (p.invDir[i][lane] > 0)
+                    {
+                        intervalMin[lane] = std::max(intervalMin[lane], t1);
+                        intervalMax[lane] = std::min(intervalMax[lane], t2);
+                    }
+                    else
+                    {
+                        intervalMin[lane] = std::max(intervalMin[lane], t2);
+                        intervalMax[lane] = std::min(intervalMax[lane], t1);
+                    }
+                }
+            }
+            if (!anyAlive(intervalMin, intervalMax, done))
+                return;
+
+            // all rays share the direction signs, so the offsets of the first active ray are valid for the packet
+            uint32 offsetFront[3];
+            uint32 offsetBack[3];
+            uint32 offsetFront3[3];
+            uint32 offsetBack3[3];
+            uint32 first = 0;
+            while (!p.isActive(first))
+                ++first;
+            for (int i=0; i<3; ++i)
+            {
+                offsetFront[i] = floatToRawIntBits(p.dir[i][first]) >> 31;
+                offsetBack[i] = offsetFront[i] ^ 1;
+                offsetFront3[i] = offsetFront[i] * 3;
+                offsetBack3[i] = offsetBack[i] * 3;
+                ++offsetFront[i];
+                ++offsetBack[i];
+            }
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float front = intBitsToFloat(tree[node + offsetFront[axis]]);
+                            float back = intBitsToFloat(tree[node + offsetBack[axis]]);
+                            float frontMax[RAY_PACKET_SIZE];
+                            float backMin[RAY_PACKET_SIZE];
+                            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                            {
+                                float tf = (front - p.org[axis][lane]) * p.invDir[axis][lane];
+                                float tb = (back - p.org[axis][lane]) * p.invDir[axis][lane];
+                                frontMax[lane] = std::min(tf, intervalMax[lane]);
+                                backMin[lane] = std::max(tb, intervalMin[lane]);
+                            }
+                            bool visitFront = anyAlive(intervalMin, frontMax, done);
+                            bool visitBack = anyAlive(backMin, intervalMax, done);
+                            // packet passes between clip zones
+                            if (!visitFront && !visitBack)
+                                break;
+                            int backNode = offset + offsetBack3[axis];
+                            // packet passes through far node only
+                            if (!visitFront)
+                            {
+                                node = backNode;
+                                std::copy(backMin, backMin + RAY_PACKET_SIZE, intervalMin);
+                                continue;
+                            }
+                            node = offset + offsetFront3[axis]; // front
+                            // packet passes through both nodes, push back node
+                            if (visitBack)
+                            {
+                                stack[stackPos].node = backNode;
+                                std::copy(backMin, backMin + RAY_PACKET_SIZE, stack[stackPos].tnear);
+                                std::copy(intervalMax, intervalMax + RAY_PACKET_SIZE, stack[stackPos].tfar);
+                                stackPos++;
+                            }
+                            // update ray intervals for front node
+                            std::copy(frontMax, frontMax + RAY_PACKET_SIZE, intervalMax);
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects with every ray still inside the node
+                            int n = tree[node + 1];
+                            while (n > 0) {
+                                uint32 laneMask = aliveMask(intervalMin, intervalMax, done);
+                                if (!laneMask)
+                                    break;
+                                uint32 hits = intersectCallback(p, laneMask, objects[offset], maxDist, stopAtFirst);
+                                if (stopAtFirst)
+                                    for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                                        done[lane] |= (hits & (1 << lane)) != 0;
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return; // should not happen
+                        float front = intBitsToFloat(tree[node + offsetFront[axis]]);
+                        float back = intBitsToFloat(tree[node + offsetBack[axis]]);
+                        node = offset;
+                        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                        {
+                            float tf = (front - p.org[axis][lane]) * p.invDir[axis][lane];
+                            float tb = (back - p.org[axis][lane]) * p.invDir[axis][lane];
+                            intervalMin[lane] = std::max(tf, intervalMin[lane]);
+                            intervalMax[lane] = std::min(tb, intervalMax[lane]);
+                        }
+                        if (!anyAlive(intervalMin, intervalMax, done))
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack, skip nodes behind the closest hits found so far
+                    stackPos--;
+                    for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                    {
+                        intervalMin[lane] = stack[stackPos].tnear[lane];
+                        intervalMax[lane] = std::min(stack[stackPos].tfar[lane], maxDist[lane]);
+                    }
+                    if (!anyAlive(intervalMin, intervalMax, done))
+                        continue;
+                    node = stack[stackPos].node;
+                    break;
+                } while (true);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -347,6 +601,44 @@ class BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            uint32 node;
+            float tnear[RAY_PACKET_SIZE];
+            float tfar[RAY_PACKET_SIZE];
+        };
+
+        //! adapts a packet callback to the scalar traversal for incoherent packets
+        template<typename RayPacketCallback>
+        class PacketLaneCallback
+        {
+            public:
+                PacketLaneCallback(RayPacketCallback &callback, const RayPacket &packet, uint32 lane, float *maxDist):
+                    iCallback(callback), iPacket(packet), iLane(lane), iMaxDist(maxDist) {}
+                // the scalar traversal is given iMaxDist[iLane] itself, so the packet callback updates it in place
+                bool operator()(const Ray &/*r*/, uint32 entry, float &/*maxDist*/, bool stopAtFirst)
+                {
+                    return iCallback(iPacket, 1 << iLane, entry, iMaxDist, stopAtFirst) != 0;
+                }
+            private:
+                RayPacketCallback &iCallback;
+                const RayPacket &iPacket;
+                uint32 iLane;
+                float *iMaxDist;
+        };
+
+        static uint32 aliveMask(const float *tMin, const float *tMax, const bool *done)
+        {
+            uint32 mask = 0;
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                mask |= uint32(!done[lane] && tMin[lane] <= tMax[lane]) << lane;
+            return mask;
+        }
+
+        static bool anyAlive(const float *tMin, const float *tMax, const bool *done)
+        {
+            return aliveMask(tMin, tMax, done) != 0;
+        }
 
         class BuildStats
         {
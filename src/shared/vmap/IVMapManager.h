@@ -65,6 +65,11 @@ namespace VMAP
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
+            batched version of isInLineOfSight(), the rays are traced in packets
+            sharing one tree traversal. Use it when many points are checked from one position (spell targets etc.)
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* x2, const float* y2, const float* z2, bool* pResult, uint32 pCount) = 0;
+            /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
             */
@@ -85,6 +90,13 @@ namespace VMAP
             */
             void setEnableHeightCalc(bool pVal) { iEnableHeightCalc = pVal; }
 
+            /**
+            Number of no longer referenced models kept loaded, so that a grid loaded again
+            does not have to read and parse its models from disk a second time.
+            0 unloads models as soon as the last tile using them is unloaded.
+            */
+            virtual void setModelCacheSize(uint32 pSize) = 0;
+
             bool isLineOfSightCalcEnabled() const { return(iEnableLineOfSightCalc); }
             bool isHeightCalcEnabled() const { return(iEnableHeightCalc); }
             bool isMapLoadingEnabled() const { return(iEnableLineOfSightCalc || iEnableHeightCalc  ); }
@@ -25,6 +25,7 @@
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <algorithm>
 
 using G3D::Vector3;
 
@@ -48,6 +49,22 @@ namespace VMAP
             bool hit;
     };
 
+    class MapRayPacketCallback
+    {
+        public:
+            MapRayPacketCallback(ModelInstance *val): prims(val), hitMask(0) {}
+            uint32 operator()(const RayPacket &packet, uint32 laneMask, uint32 entry, float *distance, bool pStopAtFirstHit=true)
+            {
+                uint32 result = prims[entry].intersectRayPacket(packet, laneMask, distance, pStopAtFirstHit);
+                hitMask |= result;
+                return result;
+            }
+            bool didHit(uint32 lane) const { return hitMask & (1 << lane); }
+        protected:
+            ModelInstance *prims;
+            uint32 hitMask;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -150,6 +167,24 @@ namespace VMAP
                 return intersectionCallBack.didHit();
     }
     //=========================================================
+    /**
+    Packet version of getIntersectionTime(), pMaxDist is updated for every lane that hit something.
+    */
+
+    void StaticMapTree::getIntersectionTimes(const RayPacket &pPacket, float *pMaxDist, bool *pHit, bool pStopAtFirstHit) const
+    {
+        float distance[RAY_PACKET_SIZE];
+        std::copy(pMaxDist, pMaxDist + RAY_PACKET_SIZE, distance);
+        MapRayPacketCallback intersectionCallBack(iTreeValues);
+        iTree.intersectRayPacket(pPacket, intersectionCallBack, distance, pStopAtFirstHit);
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            pHit[lane] = intersectionCallBack.didHit(lane);
+            if (pHit[lane])
+                pMaxDist[lane] = distance[lane];
+        }
+    }
+    //=========================================================
 
     bool StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2) const
     {
@@ -168,6 +203,52 @@ namespace VMAP
     }
     //=========================================================
     /**
+    Check line of sight from pos1 to each of the pCount positions in pos2.
+    The rays are grouped by direction octant, so every packet of RAY_PACKET_SIZE rays can share one traversal.
+    */
+
+    void StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3* pos2, bool* pResult, uint32 pCount) const
+    {
+        // (octant, index) of every ray that has to be traced
+        std::vector<std::pair<uint32, uint32> > rays;
+        rays.reserve(pCount);
+        for (uint32 i = 0; i < pCount; ++i)
+        {
+            pResult[i] = true;
+            float dist = (pos2[i] - pos1).magnitude();
+            // valid map coords should *never ever* produce float overflow, but this would produce NaNs too
+            ASSERT(dist < std::numeric_limits<float>::max());
+            // prevent NaN values which can cause BIH intersection to enter infinite loop
+            if (dist < 1e-10f)
+                continue;
+            rays.push_back(std::make_pair(RayPacket::getOctant(pos2[i] - pos1), i));
+        }
+        std::sort(rays.begin(), rays.end());
+
+        for (uint32 base = 0; base < rays.size();)
+        {
+            RayPacket packet;
+            float maxDist[RAY_PACKET_SIZE];
+            uint32 index[RAY_PACKET_SIZE];
+            uint32 lanes = 0;
+            for (; lanes < RAY_PACKET_SIZE && base < rays.size() && rays[base].first == rays[base - lanes].first; ++lanes, ++base)
+            {
+                index[lanes] = rays[base].second;
+                maxDist[lanes] = (pos2[index[lanes]] - pos1).magnitude();
+                packet.setRay(lanes, G3D::Ray::fromOriginAndDirection(pos1, (pos2[index[lanes]] - pos1)/maxDist[lanes]));
+            }
+            for (uint32 lane = lanes; lane < RAY_PACKET_SIZE; ++lane)
+                maxDist[lane] = 0.f;
+
+            bool hit[RAY_PACKET_SIZE];
+            getIntersectionTimes(packet, maxDist, hit, true);
+            for (uint32 lane = 0; lane < lanes; ++lane)
+                if (hit[lane])
+                    pResult[index[lane]] = false;
+        }
+    }
+    //=========================================================
+    /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
     */
@@ -61,6 +61,36 @@ namespace VMAP
         return hit;
     }
 
+    uint32 ModelInstance::intersectRayPacket(const RayPacket& pPacket, uint32 pLaneMask, float* pMaxDist, bool pStopAtFirstHit) const
+    {
+        if (!iModel)
+            return 0;
+
+        // child bounds are defined in object space, move every lane there with the same rotation and scale
+        RayPacket modPacket;
+        float distance[RAY_PACKET_SIZE];
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            distance[lane] = 0.f;
+            if (!(pLaneMask & (1 << lane)))
+                continue;
+            const G3D::Ray &ray = pPacket.rays[lane];
+            if (ray.intersectionTime(iBound) == G3D::inf())
+                continue;
+            Vector3 p = iInvRot * (ray.origin() - iPos) * iInvScale;
+            modPacket.setRay(lane, Ray(p, iInvRot * ray.direction()));
+            distance[lane] = pMaxDist[lane] * iInvScale;
+        }
+        if (!modPacket.activeMask)
+            return 0;
+
+        uint32 hits = iModel->IntersectRayPacket(modPacket, distance, pStopAtFirstHit);
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+            if (hits & (1 << lane))
+                pMaxDist[lane] = distance[lane] * iScale;
+        return hits;
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
@@ -34,7 +34,7 @@ namespace VMAP
 
     //=========================================================
 
-    VMapManager2::VMapManager2()
+    VMapManager2::VMapManager2() : iModelCacheSize(0)
     {
     }
 
@@ -203,6 +203,25 @@ namespace VMAP
     }
     //=========================================================
     /**
+    batched line of sight check from one source to pCount destinations
+    */
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* x2, const float* y2, const float* z2, bool* pResult, uint32 pCount)
+    {
+        std::fill(pResult, pResult + pCount, true);
+        if (!isLineOfSightCalcEnabled() || !pCount) return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree != iInstanceMapTrees.end())
+        {
+            Vector3 pos1 = convertPositionToInternalRep(x1,y1,z1);
+            std::vector<Vector3> pos2(pCount);
+            for (uint32 i = 0; i < pCount; ++i)
+                pos2[i] = convertPositionToInternalRep(x2[i],y2[i],z2[i]);
+            instanceTree->second->isInLineOfSight(pos1, &pos2[0], pResult, pCount);
+        }
+    }
+    //=========================================================
+    /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
     */
@@ -295,7 +314,12 @@ namespace VMAP
     WorldModel* VMapManager2::acquireModelInstance(const std::string &basepath, const std::string &filename)
     {
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+        if (model != iLoadedModelFiles.end() && model->second.getRefCount() == 0)
+        {
+            // still in the model cache, no need to read it again
+            iUnusedModels.remove(filename);
+        }
+        else if (model == iLoadedModelFiles.end())
         {
             WorldModel *worldmodel = new WorldModel();
             if (!worldmodel->readFile(basepath + filename + ".vmo"))
@@ -323,11 +347,43 @@ namespace VMAP
         }
         if( model->second.decRefCount() == 0)
         {
+            if (iModelCacheSize)
+            {
+                iUnusedModels.push_front(filename);
+                _trimModelCache(iModelCacheSize);
+                return;
+            }
             sLog.outDetail("VMapManager2: unloading file '%s'",filename.c_str());
             delete model->second.getModel();
             iLoadedModelFiles.erase(model);
         }
     }
+
+    //=========================================================
+
+    void VMapManager2::setModelCacheSize(uint32 pSize)
+    {
+        iModelCacheSize = pSize;
+        _trimModelCache(pSize);
+    }
+
+    //=========================================================
+    // unload the least recently released models until at most pSize are left
+
+    void VMapManager2::_trimModelCache(uint32 pSize)
+    {
+        while (iUnusedModels.size() > pSize)
+        {
+            ModelFileMap::iterator model = iLoadedModelFiles.find(iUnusedModels.back());
+            if (model != iLoadedModelFiles.end())
+            {
+                sLog.outDetail("VMapManager2: unloading file '%s'",model->first.c_str());
+                delete model->second.getModel();
+                iLoadedModelFiles.erase(model);
+            }
+            iUnusedModels.pop_back();
+        }
+    }
     //=========================================================
 
     bool VMapManager2::existsMap(const char* pBasePath, unsigned int pMapId, int x, int y)
@@ -23,6 +23,7 @@
 #include "Utilities/UnorderedMap.h"
 #include "Platform/Define.h"
 #include <G3D/Vector3.h>
+#include <list>
 
 //===========================================================
 
@@ -53,6 +54,7 @@ namespace VMAP
             WorldModel *getModel() { return iModel; }
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
+            int getRefCount() const { return iRefCount; }
         protected:
             WorldModel *iModel;
             int iRefCount;
@@ -60,6 +62,7 @@ namespace VMAP
 
     typedef UNORDERED_MAP<uint32 , StaticMapTree *> InstanceTreeMap;
     typedef UNORDERED_MAP<std::string, ManagedModel> ModelFileMap;
+    typedef std::list<std::string> ModelCacheList;
 
     class VMapManager2 : public IVMapManager
     {
@@ -70,7 +73,12 @@ namespace VMAP
             // UNORDERED_MAP<unsigned int , bool> iMapsSplitIntoTiles;
             UNORDERED_MAP<unsigned int , bool> iIgnoreMapIds;
 
+            // unreferenced models still kept in memory, most recently released first
+            ModelCacheList iUnusedModels;
+            uint32 iModelCacheSize;
+
             bool _loadMap(uint32 pMapId, const std::string &basePath, uint32 tileX, uint32 tileY);
+            void _trimModelCache(uint32 pSize);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
 
         public:
@@ -88,6 +96,7 @@ namespace VMAP
             void unloadMap(unsigned int pMapId);
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
+            void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* x2, const float* y2, const float* z2, bool* pResult, uint32 pCount);
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -100,6 +109,9 @@ namespace VMAP
             bool getAreaInfo(unsigned int pMapId, float x, float y, float &z, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const;
             bool GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float &level, float &floor, uint32 &type) const;
 
+            void setModelCacheSize(uint32 pSize);
+            uint32 getCachedModelCount() const { return iUnusedModels.size(); }
+
             WorldModel* acquireModelInstance(const std::string &basepath, const std::string &filename);
             void releaseModelInstance(const std::string &filename);
 
@@ -81,6 +81,60 @@ namespace VMAP
         return false;
     }
 
+    //! IntersectTriangle() for all rays of laneMask, the lanes are computed side by side and return the mask of lanes that hit
+    uint32 IntersectTrianglePacket(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const RayPacket &packet, uint32 laneMask, float *distance)
+    {
+        static const float EPS = 1e-5f;
+
+        const Vector3 &v0 = points[tri.idx0];
+        const Vector3 e1 = points[tri.idx1] - v0;
+        const Vector3 e2 = points[tri.idx2] - v0;
+
+        float t[RAY_PACKET_SIZE];
+        bool valid[RAY_PACKET_SIZE];
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            const float dx = packet.dir[0][lane];
+            const float dy = packet.dir[1][lane];
+            const float dz = packet.dir[2][lane];
+
+            // p = direction x e2
+            const float px = dy*e2.z - dz*e2.y;
+            const float py = dz*e2.x - dx*e2.z;
+            const float pz = dx*e2.y - dy*e2.x;
+            const float a = e1.x*px + e1.y*py + e1.z*pz;
+            // ill-conditioned lanes are masked out below, they must not branch here
+            const float f = 1.0f / a;
+
+            // s = origin - v0
+            const float sx = packet.org[0][lane] - v0.x;
+            const float sy = packet.org[1][lane] - v0.y;
+            const float sz = packet.org[2][lane] - v0.z;
+            const float u = f * (sx*px + sy*py + sz*pz);
+
+            // q = s x e1
+            const float qx = sy*e1.z - sz*e1.y;
+            const float qy = sz*e1.x - sx*e1.z;
+            const float qz = sx*e1.y - sy*e1.x;
+            const float v = f * (dx*qx + dy*qy + dz*qz);
+
+            t[lane] = f * (e2.x*qx + e2.y*qy + e2.z*qz);
+            valid[lane] = (std::fabs(a) >= EPS) & (u >= 0.0f) & (u <= 1.0f) & (v >= 0.0f) & (u + v <= 1.0f) &
+                (t[lane] > 0.0f) & (t[lane] < distance[lane]);
+        }
+
+        uint32 hits = 0;
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            if ((laneMask & (1 << lane)) && valid[lane])
+            {
+                distance[lane] = t[lane];
+                hits |= 1 << lane;
+            }
+        }
+        return hits;
+    }
+
     class TriBoundFunc
     {
         public:
@@ -332,6 +386,30 @@ namespace VMAP
         return callback.hit;
     }
 
+    struct GModelRayPacketCallback
+    {
+        GModelRayPacketCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
+            vertices(vert.begin()), triangles(tris.begin()), hitMask(0) {}
+        uint32 operator()(const RayPacket &packet, uint32 laneMask, uint32 entry, float *distance, bool /*pStopAtFirstHit*/)
+        {
+            uint32 result = IntersectTrianglePacket(triangles[entry], vertices, packet, laneMask, distance);
+            hitMask |= result;
+            return result;
+        }
+        std::vector<Vector3>::const_iterator vertices;
+        std::vector<MeshTriangle>::const_iterator triangles;
+        uint32 hitMask;
+    };
+
+    uint32 GroupModel::IntersectRayPacket(const RayPacket &packet, float *distance, bool stopAtFirstHit) const
+    {
+        if (!triangles.size())
+            return 0;
+        GModelRayPacketCallback callback(triangles, vertices);
+        meshTree.intersectRayPacket(packet, callback, distance, stopAtFirstHit);
+        return callback.hitMask;
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
         if (!triangles.size() || !iBound.contains(pos))
@@ -394,6 +472,29 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelRayPacketCallBack
+    {
+        WModelRayPacketCallBack(const std::vector<GroupModel> &mod): models(mod.begin()), hitMask(0) {}
+        uint32 operator()(const RayPacket &packet, uint32 laneMask, uint32 entry, float *distance, bool pStopAtFirstHit)
+        {
+            uint32 result = models[entry].IntersectRayPacket(packet.masked(laneMask), distance, pStopAtFirstHit);
+            hitMask |= result;
+            return result;
+        }
+        std::vector<GroupModel>::const_iterator models;
+        uint32 hitMask;
+    };
+
+    uint32 WorldModel::IntersectRayPacket(const RayPacket &packet, float *distance, bool stopAtFirstHit) const
+    {
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectRayPacket(packet, distance, stopAtFirstHit);
+
+        WModelRayPacketCallBack isc(groupModels);
+        groupTree.intersectRayPacket(packet, isc, distance, stopAtFirstHit);
+        return isc.hitMask;
+    }
+
 	float WorldModel::GetHeight(uint32 entry) const
 	{
 	 std::vector<GroupModel>::const_iterator prims;